@@ -2,12 +2,47 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <set>
 #include <algorithm>
 #include <memory>
 #include <chrono>
 #include <iomanip>
 #include <sstream>
+#include <stdexcept>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <array>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <future>
+#include <thread>
+#include <deque>
+#include <condition_variable>
+#include <functional>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 // Forward declarations
 class User;
@@ -28,6 +63,113 @@ enum class InterviewStatus {
     RESCHEDULED
 };
 
+// Formats Unix times as local "YYYY-MM-DD HH:MM" straight into a buffer. The
+// UTC offset of each hour is cached (offsets only change on hour boundaries
+// in practice) and looked up with the reentrant localtime_r on a miss. Keep
+// one instance per thread; local_formatter() hands out a thread_local one.
+class LocalTimeFormatter {
+private:
+    static const size_t CACHE_SLOTS = 256;
+    
+    struct CachedOffset {
+        int64_t hour;
+        int64_t offset;
+    };
+    std::array<CachedOffset, CACHE_SLOTS> cache;
+    
+    static int64_t floor_div(int64_t value, int64_t divisor) {
+        return value / divisor - (value % divisor < 0 ? 1 : 0);
+    }
+    
+    int64_t offset_at(int64_t seconds) {
+        int64_t hour = floor_div(seconds, 3600);
+        CachedOffset& entry = cache[static_cast<size_t>(hour) % CACHE_SLOTS];
+        if (entry.hour == hour) return entry.offset;
+        
+        std::time_t time = static_cast<std::time_t>(seconds);
+        std::tm local = {};
+#ifdef _WIN32
+        localtime_s(&local, &time);
+#else
+        localtime_r(&time, &local);
+#endif
+        int64_t local_seconds = days_from_civil(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday) * 86400 +
+                                local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec;
+        entry.hour = hour;
+        entry.offset = local_seconds - seconds;
+        return entry.offset;
+    }
+    
+    static char* put_two(char* out, int value) {
+        out[0] = static_cast<char>('0' + value / 10);
+        out[1] = static_cast<char>('0' + value % 10);
+        return out + 2;
+    }
+
+public:
+    static const size_t DATE_TIME_SIZE = 16;    // "YYYY-MM-DD HH:MM"
+    static const size_t TIME_SIZE = 5;          // "HH:MM"
+    
+    LocalTimeFormatter() {
+        for (CachedOffset& entry : cache) {
+            entry.hour = std::numeric_limits<int64_t>::min();
+        }
+    }
+    
+    // Days since 1970-01-01 in the proleptic Gregorian calendar
+    static int64_t days_from_civil(int year, int month, int day) {
+        year -= month <= 2;
+        int64_t era = (year >= 0 ? year : year - 399) / 400;
+        int64_t year_of_era = year - era * 400;
+        int64_t day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+        return era * 146097 + day_of_era - 719468;
+    }
+    
+    // Write "YYYY-MM-DD HH:MM" and return the end of the written text
+    char* format_date_time(char* out, const std::chrono::system_clock::time_point& time) {
+        int64_t seconds = static_cast<int64_t>(std::chrono::system_clock::to_time_t(time));
+        int64_t local = seconds + offset_at(seconds);
+        int64_t days = floor_div(local, 86400);
+        int64_t second_of_day = local - days * 86400;
+        
+        // Civil date from a day count
+        int64_t shifted = days + 719468;
+        int64_t era = floor_div(shifted, 146097);
+        int64_t day_of_era = shifted - era * 146097;
+        int64_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+        int64_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+        int64_t month_index = (5 * day_of_year + 2) / 153;
+        int day = static_cast<int>(day_of_year - (153 * month_index + 2) / 5 + 1);
+        int month = static_cast<int>(month_index < 10 ? month_index + 3 : month_index - 9);
+        int year = static_cast<int>(year_of_era + era * 400 + (month <= 2 ? 1 : 0));
+        
+        out = put_two(out, (year / 100) % 100);
+        out = put_two(out, year % 100);
+        *out++ = '-';
+        out = put_two(out, month);
+        *out++ = '-';
+        out = put_two(out, day);
+        *out++ = ' ';
+        out = put_two(out, static_cast<int>(second_of_day / 3600));
+        *out++ = ':';
+        return put_two(out, static_cast<int>(second_of_day / 60 % 60));
+    }
+    
+    // Write "HH:MM"
+    char* format_time(char* out, const std::chrono::system_clock::time_point& time) {
+        char date_time[DATE_TIME_SIZE];
+        format_date_time(date_time, time);
+        std::memcpy(out, date_time + 11, TIME_SIZE);
+        return out + TIME_SIZE;
+    }
+};
+
+inline LocalTimeFormatter& local_formatter() {
+    static thread_local LocalTimeFormatter formatter;
+    return formatter;
+}
+
 // Time slot structure
 struct TimeSlot {
     std::chrono::system_clock::time_point start_time;
@@ -41,300 +183,6996 @@ struct TimeSlot {
         return start_time < other.end_time && end_time > other.start_time;
     }
     
+    // Length of "YYYY-MM-DD HH:MM - HH:MM"
+    static const size_t FORMATTED_SIZE = LocalTimeFormatter::DATE_TIME_SIZE + 3 + LocalTimeFormatter::TIME_SIZE;
+    
+    // Write the local-time form into out, which must hold FORMATTED_SIZE
+    // characters, and return the end of the written text
+    char* format(char* out) const {
+        LocalTimeFormatter& formatter = local_formatter();
+        out = formatter.format_date_time(out, start_time);
+        std::memcpy(out, " - ", 3);
+        return formatter.format_time(out + 3, end_time);
+    }
+    
     std::string to_string() const {
-        auto start_t = std::chrono::system_clock::to_time_t(start_time);
-        auto end_t = std::chrono::system_clock::to_time_t(end_time);
+        char text[FORMATTED_SIZE];
+        return std::string(text, format(text));
+    }
+};
+
+// Slot at minute resolution, stored as minutes since CompactTime's epoch.
+// Eight bytes instead of sixteen, and plain integer compares.
+struct CompactSlot {
+    uint32_t start;
+    uint32_t end;
+    
+    bool overlaps(const CompactSlot& other) const {
+        return start < other.end && end > other.start;
+    }
+    
+    bool contains(const CompactSlot& other) const {
+        return start <= other.start && other.end <= end;
+    }
+};
+
+// Conversions between system_clock time points and compact minute offsets.
+// Bookings and queries round outward to whole minutes, so the compact slot
+// covers the original and no overlap is missed; availability rounds inward,
+// so it never offers time the original window does not have.
+class CompactTime {
+private:
+    static std::chrono::system_clock::time_point epoch;
+
+public:
+    // Change the epoch. Only valid before any compact slots have been stored.
+    static void set_epoch(const std::chrono::system_clock::time_point& new_epoch) {
+        epoch = new_epoch;
+    }
+    
+    static const std::chrono::system_clock::time_point& get_epoch() { return epoch; }
+    
+    static uint32_t to_minutes(const std::chrono::system_clock::time_point& time) {
+        if (time <= epoch) return 0;
+        auto minutes = std::chrono::duration_cast<std::chrono::minutes>(time - epoch).count();
+        return minutes >= static_cast<long long>(UINT32_MAX) ? UINT32_MAX
+                                                             : static_cast<uint32_t>(minutes);
+    }
+    
+    static std::chrono::system_clock::time_point from_minutes(uint32_t minutes) {
+        return epoch + std::chrono::minutes(minutes);
+    }
+    
+    // Whether the slot lies between the epoch and the last representable
+    // minute. Conversions clamp times outside that range, which would turn a
+    // real interval into an empty one, so bookings and availability outside
+    // it are rejected before they are converted. The end is compared as a
+    // minute count, since from_minutes(UINT32_MAX) overflows a nanosecond clock.
+    static bool in_range(const TimeSlot& slot) {
+        auto span = slot.end_time - epoch;
+        auto minutes = std::chrono::duration_cast<std::chrono::minutes>(span);
+        if (minutes < span) minutes += std::chrono::minutes(1);
+        return slot.start_time >= epoch && minutes.count() <= static_cast<long long>(UINT32_MAX);
+    }
+    
+    // Like to_minutes, but rounded up to the next whole minute
+    static uint32_t to_minutes_up(const std::chrono::system_clock::time_point& time) {
+        uint32_t minutes = to_minutes(time);
+        return minutes < UINT32_MAX && from_minutes(minutes) < time ? minutes + 1 : minutes;
+    }
+    
+    // Smallest minute span covering the slot. Empty slots stay empty.
+    static CompactSlot to_compact(const TimeSlot& slot) {
+        uint32_t start = to_minutes(slot.start_time);
+        return CompactSlot{start, slot.end_time > slot.start_time ? to_minutes_up(slot.end_time) : start};
+    }
+    
+    // Largest minute span inside the slot, for availability windows. May be
+    // empty for windows shorter than a minute.
+    static CompactSlot to_compact_within(const TimeSlot& slot) {
+        uint32_t start = to_minutes_up(slot.start_time);
+        uint32_t end = to_minutes(slot.end_time);
+        return CompactSlot{start, std::max(start, end)};
+    }
+    
+    static TimeSlot to_time_slot(const CompactSlot& slot) {
+        return TimeSlot(from_minutes(slot.start), from_minutes(slot.end));
+    }
+};
+
+// Default epoch: 2020-01-01 00:00 UTC
+std::chrono::system_clock::time_point CompactTime::epoch =
+    std::chrono::system_clock::from_time_t(1577836800);
+
+const uint32_t NANOSECONDS_PER_SECOND = 1000000000;
+
+// Whole Unix seconds, rounded down, and the nanoseconds past them: the form
+// snapshots and log records store times in, so a restored time is exact
+int64_t split_unix_time(const std::chrono::system_clock::time_point& time, uint32_t& nanoseconds) {
+    int64_t total = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    int64_t seconds = total / NANOSECONDS_PER_SECOND;
+    int64_t rest = total % NANOSECONDS_PER_SECOND;
+    if (rest < 0) {
+        --seconds;
+        rest += NANOSECONDS_PER_SECOND;
+    }
+    nanoseconds = static_cast<uint32_t>(rest);
+    return seconds;
+}
+
+std::chrono::system_clock::time_point join_unix_time(int64_t seconds, uint32_t nanoseconds) {
+    return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        std::chrono::seconds(seconds) + std::chrono::nanoseconds(nanoseconds)));
+}
+
+// Vectorized interval kernels over structure-of-arrays slot storage. Both
+// return the index of the first matching interval, or count if none match.
+// AVX2 checks 8 intervals per step and NEON 4; other targets use the scalar
+// loop. Build with -mavx2 (or -march=native) to enable the AVX2 path.
+struct IntervalKernels {
+    // First interval overlapping [start, end)
+    static size_t first_overlap(const uint32_t* starts, const uint32_t* ends, size_t count,
+                                uint32_t start, uint32_t end) {
+        size_t i = 0;
+#if defined(__AVX2__)
+        // Flip the sign bit so signed compares order unsigned values
+        const __m256i bias = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+        const __m256i slot_start = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(start)), bias);
+        const __m256i slot_end = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(end)), bias);
+        for (; i + 8 <= count; i += 8) {
+            __m256i s = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(starts + i)), bias);
+            __m256i e = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ends + i)), bias);
+            __m256i hit = _mm256_and_si256(_mm256_cmpgt_epi32(slot_end, s),
+                                           _mm256_cmpgt_epi32(e, slot_start));
+            int mask = _mm256_movemask_ps(_mm256_castsi256_ps(hit));
+            if (mask) return i + __builtin_ctz(mask);
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        const uint32x4_t slot_start = vdupq_n_u32(start);
+        const uint32x4_t slot_end = vdupq_n_u32(end);
+        for (; i + 4 <= count; i += 4) {
+            uint32x4_t hit = vandq_u32(vcltq_u32(vld1q_u32(starts + i), slot_end),
+                                       vcgtq_u32(vld1q_u32(ends + i), slot_start));
+            if (vmaxvq_u32(hit)) break;
+        }
+#endif
+        for (; i < count; ++i) {
+            if (starts[i] < end && ends[i] > start) return i;
+        }
+        return count;
+    }
+    
+    // First interval containing [start, end)
+    static size_t first_containing(const uint32_t* starts, const uint32_t* ends, size_t count,
+                                   uint32_t start, uint32_t end) {
+        size_t i = 0;
+#if defined(__AVX2__)
+        const __m256i bias = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+        const __m256i slot_start = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(start)), bias);
+        const __m256i slot_end = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(end)), bias);
+        for (; i + 8 <= count; i += 8) {
+            __m256i s = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(starts + i)), bias);
+            __m256i e = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ends + i)), bias);
+            __m256i miss = _mm256_or_si256(_mm256_cmpgt_epi32(s, slot_start),
+                                           _mm256_cmpgt_epi32(slot_end, e));
+            int mask = ~_mm256_movemask_ps(_mm256_castsi256_ps(miss)) & 0xff;
+            if (mask) return i + __builtin_ctz(mask);
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        const uint32x4_t slot_start = vdupq_n_u32(start);
+        const uint32x4_t slot_end = vdupq_n_u32(end);
+        for (; i + 4 <= count; i += 4) {
+            uint32x4_t hit = vandq_u32(vcleq_u32(vld1q_u32(starts + i), slot_start),
+                                       vcgeq_u32(vld1q_u32(ends + i), slot_end));
+            if (vmaxvq_u32(hit)) break;
+        }
+#endif
+        for (; i < count; ++i) {
+            if (starts[i] <= start && end <= ends[i]) return i;
+        }
+        return count;
+    }
+};
+
+// Below this many intervals a vectorized linear scan beats binary search
+const size_t LINEAR_SCAN_LIMIT = 64;
+
+// Sorted, coalesced set of minute intervals stored as separate start and end
+// arrays so the interval kernels can scan them directly
+class IntervalSet {
+private:
+    std::vector<uint32_t> starts;
+    std::vector<uint32_t> ends;
+    
+    size_t lower_bound_start(uint32_t minute) const {
+        return std::lower_bound(starts.begin(), starts.end(), minute) - starts.begin();
+    }
+
+public:
+    size_t size() const { return starts.size(); }
+    bool empty() const { return starts.empty(); }
+    CompactSlot operator[](size_t index) const { return CompactSlot{starts[index], ends[index]}; }
+    
+    // Insert a window, merging it with any windows it overlaps or touches.
+    // Returns the merged window that now contains it.
+    CompactSlot add(CompactSlot merged) {
+        if (merged.start >= merged.end) return merged;
+        
+        size_t first = lower_bound_start(merged.start);
+        if (first > 0 && ends[first - 1] >= merged.start) {
+            --first;
+        }
         
-        std::stringstream ss;
-        ss << std::put_time(std::localtime(&start_t), "%Y-%m-%d %H:%M") 
-           << " - " 
-           << std::put_time(std::localtime(&end_t), "%H:%M");
-        return ss.str();
+        size_t last = first;
+        while (last < starts.size() && starts[last] <= merged.end) {
+            merged.start = std::min(merged.start, starts[last]);
+            merged.end = std::max(merged.end, ends[last]);
+            ++last;
+        }
+        
+        if (first == last) {
+            starts.insert(starts.begin() + first, merged.start);
+            ends.insert(ends.begin() + first, merged.end);
+        } else {
+            starts[first] = merged.start;
+            ends[first] = merged.end;
+            starts.erase(starts.begin() + first + 1, starts.begin() + last);
+            ends.erase(ends.begin() + first + 1, ends.begin() + last);
+        }
+        return merged;
+    }
+    
+    // Insert many windows with a single sort and merge pass
+    void add(std::vector<CompactSlot> slots) {
+        for (size_t i = 0; i < starts.size(); ++i) {
+            slots.push_back(CompactSlot{starts[i], ends[i]});
+        }
+        std::sort(slots.begin(), slots.end(), [](const CompactSlot& a, const CompactSlot& b) {
+            return a.start < b.start;
+        });
+        
+        starts.clear();
+        ends.clear();
+        for (const CompactSlot& slot : slots) {
+            if (slot.start >= slot.end) continue;
+            if (!starts.empty() && slot.start <= ends.back()) {
+                ends.back() = std::max(ends.back(), slot.end);
+            } else {
+                starts.push_back(slot.start);
+                ends.push_back(slot.end);
+            }
+        }
+        starts.shrink_to_fit();
+        ends.shrink_to_fit();
+    }
+    
+    // Replace the contents with windows that are already sorted and coalesced.
+    // Returns false, leaving the set empty, if they are not.
+    bool assign_sorted(const uint32_t* new_starts, const uint32_t* new_ends, size_t count) {
+        starts.clear();
+        ends.clear();
+        for (size_t i = 0; i < count; ++i) {
+            if (new_starts[i] >= new_ends[i] || (i > 0 && new_starts[i] <= new_ends[i - 1])) {
+                return false;
+            }
+        }
+        starts.assign(new_starts, new_starts + count);
+        ends.assign(new_ends, new_ends + count);
+        return true;
+    }
+    
+    // Check if one window contains the slot. Windows are coalesced, so only the
+    // last window starting at or before the slot can contain it.
+    bool contains(const CompactSlot& slot) const {
+        if (starts.size() <= LINEAR_SCAN_LIMIT) {
+            return IntervalKernels::first_containing(starts.data(), ends.data(), starts.size(),
+                                                     slot.start, slot.end) != starts.size();
+        }
+        size_t it = std::upper_bound(starts.begin(), starts.end(), slot.start) - starts.begin();
+        return it > 0 && slot.end <= ends[it - 1];
+    }
+    
+    // Index of the first window still open after the given minute
+    size_t first_ending_after(uint32_t minute) const {
+        return std::upper_bound(ends.begin(), ends.end(), minute) - ends.begin();
     }
+    
+    bool operator==(const IntervalSet& other) const { return starts == other.starts && ends == other.ends; }
 };
 
-// User class
-class User {
+// Weekly availability pattern, e.g. Tuesdays and Thursdays 9-12. Windows are
+// minute offsets into a 7-day week that begins at the anchor (normally a
+// Monday midnight), and the week repeats from the anchor until the end time.
+// Exceptions such as holidays are cut out of every occurrence they touch.
+// Weeks are fixed spans of minutes, so windows do not follow daylight-saving
+// changes. Occurrences are computed on demand, never stored.
+class RecurringAvailability {
+public:
+    static const uint32_t WEEK_MINUTES = 7 * 24 * 60;
+
 private:
-    static int next_id;
-    int user_id;
-    std::string name;
-    std::string email;
-    UserRole role;
-    std::vector<TimeSlot> availability;
-    std::set<int> scheduled_interviews;
+    uint32_t anchor;            // start of the first week, minutes since the epoch
+    uint32_t until;
+    IntervalSet windows;        // minutes into the week
+    IntervalSet exceptions;     // minutes since the epoch
 
 public:
-    User(const std::string& name, const std::string& email, UserRole role)
-        : user_id(next_id++), name(name), email(email), role(role) {}
+    // Weeks before the compact epoch are skipped, keeping the weekday phase
+    RecurringAvailability(std::chrono::system_clock::time_point first_week,
+                          const std::chrono::system_clock::time_point& end) {
+        const auto week = std::chrono::minutes(WEEK_MINUTES);
+        if (first_week < CompactTime::get_epoch()) {
+            first_week += week * ((CompactTime::get_epoch() - first_week + week - std::chrono::minutes(1)) / week);
+        }
+        anchor = CompactTime::to_minutes(first_week);
+        until = CompactTime::to_minutes(end);
+    }
     
-    // Getters
-    int get_id() const { return user_id; }
-    const std::string& get_name() const { return name; }
-    const std::string& get_email() const { return email; }
-    UserRole get_role() const { return role; }
-    const std::vector<TimeSlot>& get_availability() const { return availability; }
-    const std::set<int>& get_scheduled_interviews() const { return scheduled_interviews; }
+    // Rule read back from minute form, e.g. from a snapshot
+    RecurringAvailability(uint32_t anchor, uint32_t until) : anchor(anchor), until(until) {}
     
-    // Add availability slot
-    void add_availability(const TimeSlot& slot) {
-        availability.push_back(slot);
+    CompactSlot span() const { return CompactSlot{anchor, until}; }
+    const IntervalSet& get_windows() const { return windows; }
+    const IntervalSet& get_exceptions() const { return exceptions; }
+    
+    bool operator==(const RecurringAvailability& other) const {
+        return anchor == other.anchor && until == other.until && windows == other.windows &&
+               exceptions == other.exceptions;
     }
     
-    // Check if user is available during a time slot
-    bool is_available(const TimeSlot& slot) const {
-        for (const auto& available_slot : availability) {
-            if (slot.start_time >= available_slot.start_time && 
-                slot.end_time <= available_slot.end_time) {
-                return true;
+    // Window on the given day of the week (0 is the anchor's day), in minutes
+    // after that day's midnight. The window may run past midnight; anything
+    // past the end of the week continues at the start of the week.
+    void add_window(int day, int start_minute, int end_minute) {
+        if (day < 0 || day >= 7 || start_minute < 0 || end_minute <= start_minute ||
+            static_cast<uint32_t>(end_minute - start_minute) > WEEK_MINUTES) {
+            throw std::runtime_error("Invalid weekly window");
+        }
+        uint32_t start = static_cast<uint32_t>(day * 24 * 60 + start_minute) % WEEK_MINUTES;
+        uint32_t end = start + static_cast<uint32_t>(end_minute - start_minute);
+        if (end <= WEEK_MINUTES) {
+            windows.add(CompactSlot{start, end});
+        } else {
+            windows.add(CompactSlot{start, WEEK_MINUTES});
+            windows.add(CompactSlot{0, end - WEEK_MINUTES});
+        }
+    }
+    
+    void add_exception(const TimeSlot& slot) { exceptions.add(CompactTime::to_compact(slot)); }
+    void add_exception(const CompactSlot& slot) { exceptions.add(slot); }
+    
+    // Append the occurrences inside range to out, clipped to it, in start
+    // order, coalesced and with the exceptions removed
+    void expand(const CompactSlot& range, std::vector<CompactSlot>& out) const {
+        uint32_t from = std::max(range.start, anchor);
+        uint32_t to = std::min(range.end, until);
+        if (from >= to || windows.empty()) return;
+        
+        size_t first = out.size();
+        for (uint64_t week = anchor + static_cast<uint64_t>((from - anchor) / WEEK_MINUTES) * WEEK_MINUTES;
+             week < to; week += WEEK_MINUTES) {
+            for (size_t i = 0; i < windows.size(); ++i) {
+                uint64_t start = week + windows[i].start;
+                uint64_t end = week + windows[i].end;
+                if (end <= from) continue;
+                if (start >= to) break;
+                CompactSlot occurrence{static_cast<uint32_t>(std::max<uint64_t>(start, from)),
+                                       static_cast<uint32_t>(std::min<uint64_t>(end, to))};
+                if (out.size() > first && occurrence.start <= out.back().end) {
+                    out.back().end = std::max(out.back().end, occurrence.end);
+                } else {
+                    out.push_back(occurrence);
+                }
             }
         }
-        return false;
+        
+        size_t k = exceptions.first_ending_after(from);
+        if (k == exceptions.size() || exceptions[k].start >= to) return;
+        std::vector<CompactSlot> kept;
+        for (size_t i = first; i < out.size(); ++i) {
+            uint32_t cursor = out[i].start;
+            while (k < exceptions.size() && exceptions[k].end <= cursor) ++k;
+            for (size_t j = k; j < exceptions.size() && exceptions[j].start < out[i].end; ++j) {
+                if (exceptions[j].start > cursor) kept.push_back(CompactSlot{cursor, exceptions[j].start});
+                cursor = std::max(cursor, exceptions[j].end);
+            }
+            if (cursor < out[i].end) kept.push_back(CompactSlot{cursor, out[i].end});
+        }
+        out.resize(first);
+        out.insert(out.end(), kept.begin(), kept.end());
     }
+};
+
+#ifdef CLOUDFIT_METRICS
+
+// Scheduler operations with their own call counter and latency histogram.
+// The O(1) getters are not instrumented.
+enum class MetricOp : uint8_t {
+    ADD_USER,
+    ADD_AVAILABILITY,
+    ENABLE_CALENDAR,
+    SCHEDULE_INTERVIEW,
+    SCHEDULE_BATCH,
+    FREE_SLOT_MASK,
+    HAS_CONFLICT,
+    FIND_FREE_SLOTS,
+    CANCEL_INTERVIEW,
+    SET_NOTES,
+    RESCHEDULE_INTERVIEW,
+    UPDATE_STATUS,
+    GET_USER_INTERVIEWS,
+    GET_ALL_INTERVIEWS,
+    FIND_INTERVIEWS,
+    COUNT_INTERVIEWS,
+    RANGE_QUERY,
+    SAVE_SNAPSHOT,
+    LOAD_SNAPSHOT,
+    REPLAY_LOG,
+    COMPACT_LOG,
+    RESERVE_HOLDS,
+    RESOLVE_HOLDS,
+    EXTERNAL_BOOKING,
+    ARCHIVE_INTERVIEWS,
+    COUNT
+};
+
+const char* metric_op_name(MetricOp op) {
+    static const char* const names[] = {
+        "add_user", "add_availability", "enable_calendar", "schedule_interview", "schedule_batch",
+        "free_slot_mask", "has_conflict", "find_free_slots", "cancel_interview", "set_interview_notes",
+        "reschedule_interview", "update_interview_status", "get_user_interviews", "get_all_interviews",
+        "find_interviews", "count_interviews", "interviews_in_range", "save_snapshot", "load_snapshot",
+        "replay_log", "compact_log", "reserve_holds", "resolve_holds", "external_booking",
+        "archive_interviews"
+    };
+    return names[static_cast<size_t>(op)];
+}
+
+// Process-wide scheduler instrumentation, built in with -DCLOUDFIT_METRICS.
+// Each thread writes only its own shard, so recording is a few relaxed
+// stores with no shared cache lines; collect() sums the shards on demand.
+class SchedulerMetrics {
+public:
+    static const size_t OP_COUNT = static_cast<size_t>(MetricOp::COUNT);
     
-    // Add scheduled interview
-    void add_scheduled_interview(int interview_id) {
-        scheduled_interviews.insert(interview_id);
+    // Histogram bucket b counts values of bit width b, i.e. up to 2^b - 1;
+    // the last bucket is unbounded
+    static const size_t LATENCY_BUCKETS = 32;      // nanoseconds
+    static const size_t SCAN_BUCKETS = 17;         // bookings examined by one conflict check
+    static const size_t REJECTION_REASONS = 16;    // indexed by ScheduleError
+    static const size_t SLOW_CALLS = 8;            // slowest calls kept per thread
+    
+    // One of the slowest calls seen, to find the calendars behind them
+    struct SlowCall {
+        MetricOp op;
+        int user_id;
+        int peer_id;            // interviewer of a booking, otherwise 0
+        uint64_t latency_ns;
+        uint64_t scan_length;   // bookings examined by conflict checks during the call
+    };
+    
+    // Totals over all threads
+    struct Snapshot {
+        uint64_t calls[OP_COUNT];
+        uint64_t latency_sum_ns[OP_COUNT];
+        uint64_t latency_buckets[OP_COUNT][LATENCY_BUCKETS];
+        uint64_t rejections[REJECTION_REASONS];
+        uint64_t scan_buckets[SCAN_BUCKETS];
+        uint64_t scan_sum;
+        uint64_t scan_count;
+        std::vector<SlowCall> slow_calls;   // slowest first, at most SLOW_CALLS
+        size_t threads;
+    };
+    
+    static size_t bucket_of(uint64_t value, size_t buckets) {
+        size_t width = value ? 64 - static_cast<size_t>(__builtin_clzll(value)) : 0;
+        return std::min(width, buckets - 1);
     }
+
+private:
+    typedef std::atomic<uint64_t> Counter;
     
-    // Remove scheduled interview
-    void remove_scheduled_interview(int interview_id) {
-        scheduled_interviews.erase(interview_id);
+    struct Shard {
+        Counter calls[OP_COUNT] = {};
+        Counter latency_sum_ns[OP_COUNT] = {};
+        Counter latency_buckets[OP_COUNT][LATENCY_BUCKETS] = {};
+        Counter rejections[REJECTION_REASONS] = {};
+        Counter scan_buckets[SCAN_BUCKETS] = {};
+        Counter scan_sum{0};
+        Counter scan_count{0};
+        
+        // Slowest calls; the owner only locks when a call beats slow_floor
+        std::mutex slow_mutex;
+        SlowCall slow[SLOW_CALLS] = {};
+        size_t slow_count = 0;
+        uint64_t slow_floor = 0;
+    };
+    
+    // Single-writer increment: only the owning thread stores to its shard
+    static void bump(Counter& counter, uint64_t amount = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
     }
     
-    std::string role_to_string() const {
-        return (role == UserRole::HR_MANAGER) ? "HR Manager" : "Interviewer";
+    static std::mutex& registry_mutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+    
+    static std::vector<std::unique_ptr<Shard>>& shards() {
+        static std::vector<std::unique_ptr<Shard>> all;
+        return all;
+    }
+    
+    // The calling thread's shard, registered on first use. Shards outlive
+    // their threads so no counts are lost.
+    static Shard& local() {
+        thread_local Shard* shard = nullptr;
+        if (!shard) {
+            std::unique_ptr<Shard> created(new Shard());
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            shard = created.get();
+            shards().push_back(std::move(created));
+        }
+        return *shard;
+    }
+    
+    static void record_slow(Shard& shard, const SlowCall& call) {
+        std::lock_guard<std::mutex> lock(shard.slow_mutex);
+        if (shard.slow_count < SLOW_CALLS) {
+            shard.slow[shard.slow_count++] = call;
+        } else {
+            size_t fastest = 0;
+            for (size_t i = 1; i < SLOW_CALLS; ++i) {
+                if (shard.slow[i].latency_ns < shard.slow[fastest].latency_ns) fastest = i;
+            }
+            shard.slow[fastest] = call;
+        }
+        if (shard.slow_count == SLOW_CALLS) {
+            shard.slow_floor = shard.slow[0].latency_ns;
+            for (size_t i = 1; i < SLOW_CALLS; ++i) {
+                shard.slow_floor = std::min(shard.slow_floor, shard.slow[i].latency_ns);
+            }
+        }
+    }
+
+public:
+    // Times one call of a public operation, including lock waits
+    class Timer {
+    private:
+        Shard& shard;
+        MetricOp op;
+        int user_id;
+        int peer_id;
+        uint64_t scan_before;
+        std::chrono::steady_clock::time_point start;
+    
+    public:
+        Timer(MetricOp op, int user_id, int peer_id)
+            : shard(local()), op(op), user_id(user_id), peer_id(peer_id),
+              scan_before(shard.scan_sum.load(std::memory_order_relaxed)),
+              start(std::chrono::steady_clock::now()) {}
+        
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+        
+        ~Timer() {
+            uint64_t ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count());
+            size_t index = static_cast<size_t>(op);
+            bump(shard.calls[index]);
+            bump(shard.latency_sum_ns[index], ns);
+            bump(shard.latency_buckets[index][bucket_of(ns, LATENCY_BUCKETS)]);
+            if (ns > shard.slow_floor) {
+                uint64_t scanned = shard.scan_sum.load(std::memory_order_relaxed) - scan_before;
+                record_slow(shard, SlowCall{op, user_id, peer_id, ns, scanned});
+            }
+        }
+    };
+    
+    // Number of bookings one conflict check examined; 0 for a bitmap lookup
+    static void record_scan(uint64_t length) {
+        Shard& shard = local();
+        bump(shard.scan_sum, length);
+        bump(shard.scan_count);
+        bump(shard.scan_buckets[bucket_of(length, SCAN_BUCKETS)]);
+    }
+    
+    static void record_rejection(size_t reason) {
+        bump(local().rejections[std::min(reason, REJECTION_REASONS - 1)]);
+    }
+    
+    // Sum every thread's shard. Counts from calls still in flight may be
+    // missed; each counter is individually consistent.
+    static Snapshot collect() {
+        Snapshot snapshot = Snapshot();
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        for (const std::unique_ptr<Shard>& shard : shards()) {
+            for (size_t op = 0; op < OP_COUNT; ++op) {
+                snapshot.calls[op] += shard->calls[op].load(std::memory_order_relaxed);
+                snapshot.latency_sum_ns[op] += shard->latency_sum_ns[op].load(std::memory_order_relaxed);
+                for (size_t b = 0; b < LATENCY_BUCKETS; ++b) {
+                    snapshot.latency_buckets[op][b] += shard->latency_buckets[op][b].load(std::memory_order_relaxed);
+                }
+            }
+            for (size_t r = 0; r < REJECTION_REASONS; ++r) {
+                snapshot.rejections[r] += shard->rejections[r].load(std::memory_order_relaxed);
+            }
+            for (size_t b = 0; b < SCAN_BUCKETS; ++b) {
+                snapshot.scan_buckets[b] += shard->scan_buckets[b].load(std::memory_order_relaxed);
+            }
+            snapshot.scan_sum += shard->scan_sum.load(std::memory_order_relaxed);
+            snapshot.scan_count += shard->scan_count.load(std::memory_order_relaxed);
+            
+            std::lock_guard<std::mutex> slow_lock(shard->slow_mutex);
+            snapshot.slow_calls.insert(snapshot.slow_calls.end(), shard->slow, shard->slow + shard->slow_count);
+        }
+        std::sort(snapshot.slow_calls.begin(), snapshot.slow_calls.end(),
+                  [](const SlowCall& a, const SlowCall& b) { return a.latency_ns > b.latency_ns; });
+        if (snapshot.slow_calls.size() > SLOW_CALLS) snapshot.slow_calls.resize(SLOW_CALLS);
+        snapshot.threads = shards().size();
+        return snapshot;
     }
 };
 
-int User::next_id = 1;
+#define CLOUDFIT_TIME_OP(op, user_id, peer_id) SchedulerMetrics::Timer metrics_timer(MetricOp::op, user_id, peer_id)
+#define CLOUDFIT_COUNT_SCAN(length) SchedulerMetrics::record_scan(length)
+#define CLOUDFIT_COUNT_REJECTION(error) SchedulerMetrics::record_rejection(static_cast<size_t>(error))
 
-// Interview class
-class Interview {
+#else
+
+// Without CLOUDFIT_METRICS the instrumentation compiles to nothing
+#define CLOUDFIT_TIME_OP(op, user_id, peer_id)
+#define CLOUDFIT_COUNT_SCAN(length) ((void)0)
+#define CLOUDFIT_COUNT_REJECTION(error) ((void)0)
+
+#endif
+
+// Sorted index of a user's active bookings, used for O(log k) conflict checks.
+// A user's active bookings never overlap each other, so ordering them by start
+// time also orders them by end time. Stored as separate arrays for the
+// interval kernels.
+class BookingIndex {
 private:
-    static int next_id;
-    int interview_id;
-    std::string candidate_name;
-    std::string position;
-    int hr_manager_id;
-    int interviewer_id;
-    TimeSlot time_slot;
-    InterviewStatus status;
-    std::string notes;
+    std::vector<uint32_t> starts;
+    std::vector<uint32_t> ends;
+    std::vector<int> interview_ids;
+    
+public:
+    size_t size() const { return starts.size(); }
+    bool empty() const { return starts.empty(); }
+    uint32_t start(size_t index) const { return starts[index]; }
+    uint32_t end(size_t index) const { return ends[index]; }
+    int interview_id(size_t index) const { return interview_ids[index]; }
+    
+    // Index of the first booking starting at or after the given minute
+    size_t first_starting_at(uint32_t minute) const {
+        return std::lower_bound(starts.begin(), starts.end(), minute) - starts.begin();
+    }
+    
+    // Index of the first booking still running after the given minute
+    size_t first_ending_after(uint32_t minute) const {
+        return std::upper_bound(ends.begin(), ends.end(), minute) - ends.begin();
+    }
+    
+    void insert(int interview_id, const CompactSlot& slot) {
+        size_t pos = first_starting_at(slot.start);
+        starts.insert(starts.begin() + pos, slot.start);
+        ends.insert(ends.begin() + pos, slot.end);
+        interview_ids.insert(interview_ids.begin() + pos, interview_id);
+    }
+    
+    bool erase(int interview_id, const CompactSlot& slot) {
+        for (size_t pos = first_starting_at(slot.start);
+             pos < starts.size() && starts[pos] == slot.start; ++pos) {
+            if (interview_ids[pos] == interview_id) {
+                starts.erase(starts.begin() + pos);
+                ends.erase(ends.begin() + pos);
+                interview_ids.erase(interview_ids.begin() + pos);
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // Check whether the slot overlaps any booking other than ignore_interview_id.
+    // Small calendars are scanned with the overlap kernel; larger ones only
+    // need the bookings starting right before slot.end.
+    bool overlaps(const CompactSlot& slot, int ignore_interview_id = 0) const {
+        size_t count = starts.size();
+        if (count <= LINEAR_SCAN_LIMIT) {
+            for (size_t i = 0; i < count; ++i) {
+                i += IntervalKernels::first_overlap(starts.data() + i, ends.data() + i, count - i,
+                                                    slot.start, slot.end);
+                if (i < count && interview_ids[i] != ignore_interview_id) {
+                    CLOUDFIT_COUNT_SCAN(i + 1);
+                    return true;
+                }
+            }
+            CLOUDFIT_COUNT_SCAN(count);
+            return false;
+        }
+        
+        // Scan length is the binary search probes plus the bookings walked
+        size_t pos = first_starting_at(slot.end);
+        while (pos > 0) {
+            --pos;
+            if (interview_ids[pos] == ignore_interview_id) continue;
+            CLOUDFIT_COUNT_SCAN(SchedulerMetrics::bucket_of(count, 64) + first_starting_at(slot.end) - pos);
+            return ends[pos] > slot.start;
+        }
+        CLOUDFIT_COUNT_SCAN(SchedulerMetrics::bucket_of(count, 64) + first_starting_at(slot.end));
+        return false;
+    }
+};
 
+// Fixed-granularity calendar: one availability bit and one busy bit per
+// 15-minute quantum over a horizon of whole days. For quantum-aligned slots,
+// availability and conflict checks become bit tests, and a pair of users'
+// free time is avail_a & avail_b & ~busy_a & ~busy_b a word at a time.
+class QuantumCalendar {
 public:
-    Interview(const std::string& candidate, const std::string& pos, 
-              int hr_id, int int_id, const TimeSlot& slot)
-        : interview_id(next_id++), candidate_name(candidate), position(pos),
-          hr_manager_id(hr_id), interviewer_id(int_id), time_slot(slot),
-          status(InterviewStatus::SCHEDULED) {}
+    static const uint32_t QUANTUM_MINUTES = 15;
+    static const uint32_t QUANTA_PER_DAY = 24 * 60 / QUANTUM_MINUTES;
+
+private:
+    uint32_t first_quantum;     // Horizon start in quanta since the epoch
+    uint32_t quantum_count;
+    std::vector<uint64_t> available;
+    std::vector<uint64_t> busy;
     
-    // Getters
-    int get_id() const { return interview_id; }
-    const std::string& get_candidate_name() const { return candidate_name; }
-    const std::string& get_position() const { return position; }
-    int get_hr_manager_id() const { return hr_manager_id; }
-    int get_interviewer_id() const { return interviewer_id; }
-    const TimeSlot& get_time_slot() const { return time_slot; }
-    InterviewStatus get_status() const { return status; }
-    const std::string& get_notes() const { return notes; }
+    static void set_bits(std::vector<uint64_t>& bits, uint32_t from, uint32_t to, bool value) {
+        for (uint32_t bit = from; bit < to; ) {
+            uint32_t offset = bit % 64;
+            uint32_t span = std::min<uint32_t>(64 - offset, to - bit);
+            uint64_t mask = (span == 64 ? ~0ULL : ((1ULL << span) - 1)) << offset;
+            if (value) bits[bit / 64] |= mask; else bits[bit / 64] &= ~mask;
+            bit += span;
+        }
+    }
     
-    // Setters
-    void set_status(InterviewStatus new_status) { status = new_status; }
-    void set_notes(const std::string& new_notes) { notes = new_notes; }
-    void set_time_slot(const TimeSlot& new_slot) { time_slot = new_slot; }
+    // 64 bits starting at an arbitrary relative bit; bits past the horizon are 0
+    uint64_t word_at(const std::vector<uint64_t>& bits, uint32_t bit) const {
+        if (bit >= quantum_count) return 0;
+        uint32_t index = bit / 64, offset = bit % 64;
+        uint64_t word = bits[index] >> offset;
+        if (offset && index + 1 < bits.size()) word |= bits[index + 1] << (64 - offset);
+        uint32_t remaining = quantum_count - bit;
+        if (remaining < 64) word &= (1ULL << remaining) - 1;
+        return word;
+    }
     
-    std::string status_to_string() const {
-        switch (status) {
-            case InterviewStatus::SCHEDULED: return "Scheduled";
-            case InterviewStatus::COMPLETED: return "Completed";
-            case InterviewStatus::CANCELLED: return "Cancelled";
-            case InterviewStatus::RESCHEDULED: return "Rescheduled";
-            default: return "Unknown";
+    // Relative quantum range [from, to) fully inside a slot, clipped to the horizon
+    void inner_range(const CompactSlot& slot, uint32_t& from, uint32_t& to) const {
+        uint32_t start = (slot.start / QUANTUM_MINUTES) +
+                         (slot.start % QUANTUM_MINUTES ? 1 : 0);
+        uint32_t end = slot.end / QUANTUM_MINUTES;
+        from = std::min(std::max(start, first_quantum) - first_quantum, quantum_count);
+        to = std::min(std::max(end, first_quantum) - first_quantum, quantum_count);
+    }
+    
+    bool all_set(const std::vector<uint64_t>& bits, uint32_t from, uint32_t to) const {
+        for (uint32_t bit = from; bit < to; bit += 64) {
+            uint32_t span = std::min<uint32_t>(64, to - bit);
+            uint64_t mask = span == 64 ? ~0ULL : ((1ULL << span) - 1);
+            if ((word_at(bits, bit) & mask) != mask) return false;
+        }
+        return true;
+    }
+    
+    bool any_set(const std::vector<uint64_t>& bits, uint32_t from, uint32_t to) const {
+        for (uint32_t bit = from; bit < to; bit += 64) {
+            uint32_t span = std::min<uint32_t>(64, to - bit);
+            uint64_t mask = span == 64 ? ~0ULL : ((1ULL << span) - 1);
+            if (word_at(bits, bit) & mask) return true;
+        }
+        return false;
+    }
+
+public:
+    // Cover the whole days touched by the horizon
+    explicit QuantumCalendar(const CompactSlot& horizon) {
+        uint32_t minutes_per_day = QUANTA_PER_DAY * QUANTUM_MINUTES;
+        uint32_t first_day = horizon.start / minutes_per_day;
+        uint32_t last_day = (horizon.end + minutes_per_day - 1) / minutes_per_day;
+        first_quantum = first_day * QUANTA_PER_DAY;
+        quantum_count = std::max<uint32_t>(last_day, first_day + 1) * QUANTA_PER_DAY - first_quantum;
+        available.assign((quantum_count + 63) / 64, 0);
+        busy.assign((quantum_count + 63) / 64, 0);
+    }
+    
+    static bool is_aligned(const CompactSlot& slot) {
+        return slot.start % QUANTUM_MINUTES == 0 && slot.end % QUANTUM_MINUTES == 0;
+    }
+    
+    // True if the slot is quantum-aligned and inside the horizon
+    bool covers(const CompactSlot& slot) const {
+        return is_aligned(slot) && slot.start < slot.end &&
+               slot.start / QUANTUM_MINUTES >= first_quantum &&
+               slot.end / QUANTUM_MINUTES <= first_quantum + quantum_count;
+    }
+    
+    CompactSlot horizon() const {
+        return CompactSlot{first_quantum * QUANTUM_MINUTES,
+                           (first_quantum + quantum_count) * QUANTUM_MINUTES};
+    }
+    
+    void mark_available(const CompactSlot& slot) {
+        uint32_t from, to;
+        inner_range(slot, from, to);
+        set_bits(available, from, to, true);
+    }
+    
+    void set_busy(const CompactSlot& slot, bool value) {
+        uint32_t from, to;
+        inner_range(slot, from, to);
+        set_bits(busy, from, to, value);
+    }
+    
+    // Both checks expect a slot for which covers() is true
+    bool is_available(const CompactSlot& slot) const {
+        uint32_t from, to;
+        inner_range(slot, from, to);
+        return all_set(available, from, to);
+    }
+    
+    bool is_busy(const CompactSlot& slot) const {
+        uint32_t from, to;
+        inner_range(slot, from, to);
+        return any_set(busy, from, to);
+    }
+    
+    // Free time of both calendars inside the window, as back-to-back slots of
+    // length_quanta quanta taken from the start of each free run. The window
+    // must be covered by both calendars.
+    static void find_free(const QuantumCalendar& a, const QuantumCalendar& b,
+                          const CompactSlot& window, uint32_t length_quanta,
+                          size_t max_slots, std::vector<CompactSlot>& out) {
+        uint32_t first = window.start / QUANTUM_MINUTES;
+        uint32_t last = window.end / QUANTUM_MINUTES;
+        uint32_t run_start = 0, run_length = 0;
+        
+        auto flush = [&]() {
+            for (uint32_t q = run_start; q + length_quanta <= run_start + run_length &&
+                                         out.size() < max_slots; q += length_quanta) {
+                out.push_back(CompactSlot{q * QUANTUM_MINUTES, (q + length_quanta) * QUANTUM_MINUTES});
+            }
+            run_length = 0;
+        };
+        
+        for (uint32_t q = first; q < last && out.size() < max_slots; q += 64) {
+            uint32_t span = std::min<uint32_t>(64, last - q);
+            uint32_t qa = q - a.first_quantum, qb = q - b.first_quantum;
+            uint64_t free = a.word_at(a.available, qa) & b.word_at(b.available, qb) &
+                            ~a.word_at(a.busy, qa) & ~b.word_at(b.busy, qb);
+            if (span < 64) free &= (1ULL << span) - 1;
+            
+            // Walk alternating runs of ones and zeros with ctz
+            for (uint32_t bit = 0; bit < span; ) {
+                uint64_t rest = free >> bit;
+                if (rest & 1) {
+                    uint32_t ones = ~rest ? static_cast<uint32_t>(__builtin_ctzll(~rest)) : 64 - bit;
+                    ones = std::min(ones, span - bit);
+                    if (run_length == 0) run_start = q + bit;
+                    run_length += ones;
+                    bit += ones;
+                } else {
+                    if (run_length) flush();
+                    uint32_t zeros = rest ? static_cast<uint32_t>(__builtin_ctzll(rest)) : span - bit;
+                    bit += std::min(zeros, span - bit);
+                }
+            }
+        }
+        if (run_length) flush();
+    }
+};
+
+// Contiguous range of ids reserved from an IdGenerator
+struct IdBlock {
+    int next;
+    int end;
+    
+    bool empty() const { return next >= end; }
+    int take() { return next++; }
+};
+
+// Thread-safe id source. Single ids come from one atomic counter, so ids stay
+// dense. Bulk loaders reserve a block per worker and touch the shared counter
+// once per block instead of once per object.
+class IdGenerator {
+private:
+    alignas(64) std::atomic<int> next_id;
+
+public:
+    explicit IdGenerator(int first_id = 1) : next_id(first_id) {}
+    
+    int next() { return next_id.fetch_add(1, std::memory_order_relaxed); }
+    
+    IdBlock reserve(int count) {
+        int first = next_id.fetch_add(count, std::memory_order_relaxed);
+        return IdBlock{first, first + count};
+    }
+    
+    // Take an id from a block owned by the calling thread, refilling it as needed
+    int next_from(IdBlock& thread_block, int block_size) {
+        if (thread_block.empty()) thread_block = reserve(block_size);
+        return thread_block.take();
+    }
+    
+    // Make sure future ids are greater than an id assigned elsewhere
+    void advance_past(int id) {
+        int current = next_id.load(std::memory_order_relaxed);
+        while (current <= id &&
+               !next_id.compare_exchange_weak(current, id + 1, std::memory_order_relaxed)) {
+        }
+    }
+};
+
+// Process-wide pool of immutable strings. Each distinct value is stored once
+// and never freed, so its address can serve as a handle. Reads of an interned
+// value need no lock; interning takes a shared lock on a hit and an exclusive
+// one on first insertion.
+class StringPool {
+private:
+    mutable std::shared_timed_mutex mutex;
+    std::unordered_set<std::string> strings;
+
+public:
+    const std::string* intern(const std::string& value) {
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(mutex);
+            auto it = strings.find(value);
+            if (it != strings.end()) return &*it;
+        }
+        std::unique_lock<std::shared_timed_mutex> lock(mutex);
+        return &*strings.insert(value).first;
+    }
+    
+    // The interned copy of value, or nullptr if it was never interned
+    const std::string* find(const std::string& value) const {
+        std::shared_lock<std::shared_timed_mutex> lock(mutex);
+        auto it = strings.find(value);
+        return it != strings.end() ? &*it : nullptr;
+    }
+    
+    size_t size() const {
+        std::shared_lock<std::shared_timed_mutex> lock(mutex);
+        return strings.size();
+    }
+    
+    static StringPool& global() {
+        static StringPool pool;
+        return pool;
+    }
+};
+
+// Handle to a string in the global StringPool: one pointer instead of a
+// std::string, and equal values compare by address
+class InternedString {
+private:
+    const std::string* value;
+    
+    explicit InternedString(const std::string* interned) : value(interned) {}
+
+public:
+    InternedString() : value(StringPool::global().intern(std::string())) {}
+    InternedString(const std::string& text) : value(StringPool::global().intern(text)) {}
+    
+    // Handle for a value that may not be interned yet, without adding it.
+    // Returns false if no string with that value exists.
+    static bool lookup(const std::string& text, InternedString& out) {
+        const std::string* interned = StringPool::global().find(text);
+        if (!interned) return false;
+        out = InternedString(interned);
+        return true;
+    }
+    
+    const std::string& str() const { return *value; }
+    
+    bool operator==(const InternedString& other) const { return value == other.value; }
+    bool operator!=(const InternedString& other) const { return value != other.value; }
+};
+
+// User class
+class User {
+private:
+    static IdGenerator ids;
+    int user_id;
+    InternedString name;
+    InternedString email;
+    UserRole role;
+    IntervalSet availability;
+    std::set<int> scheduled_interviews;
+    BookingIndex active_bookings;
+    
+    // Optional bitmap mirror of availability and bookings. It only exists while
+    // everything the user holds is quantum-aligned, so it always agrees exactly
+    // with the interval structures above.
+    std::unique_ptr<QuantumCalendar> calendar;
+    
+    // Weekly rules and, optionally, their occurrences expanded over a horizon.
+    // Only allocated once the user has a rule.
+    struct RecurringState {
+        std::vector<RecurringAvailability> rules;
+        IntervalSet cache;
+        CompactSlot cache_horizon{0, 0};
+    };
+    std::unique_ptr<RecurringState> recurring;
+    
+    void drop_calendar_if_unaligned(const CompactSlot& slot) {
+        if (calendar && !QuantumCalendar::is_aligned(slot)) calendar.reset();
+    }
+    
+    static void check_in_range(const TimeSlot& slot) {
+        if (!CompactTime::in_range(slot)) {
+            throw std::runtime_error("Availability is outside the range the scheduler can store");
+        }
+    }
+    
+    // Sort windows from out[first] on by start and merge overlapping or touching ones
+    static void coalesce(std::vector<CompactSlot>& out, size_t first) {
+        std::sort(out.begin() + first, out.end(), [](const CompactSlot& a, const CompactSlot& b) {
+            return a.start < b.start;
+        });
+        size_t kept = first;
+        for (size_t i = first; i < out.size(); ++i) {
+            if (kept > first && out[i].start <= out[kept - 1].end) {
+                out[kept - 1].end = std::max(out[kept - 1].end, out[i].end);
+            } else {
+                out[kept++] = out[i];
+            }
+        }
+        out.resize(kept);
+    }
+    
+    // Append the windows of an interval set that overlap range, clipped to it
+    static void clip_windows(const IntervalSet& set, const CompactSlot& range, std::vector<CompactSlot>& out) {
+        for (size_t i = set.first_ending_after(range.start); i < set.size() && set[i].start < range.end; ++i) {
+            out.push_back(CompactSlot{std::max(set[i].start, range.start), std::min(set[i].end, range.end)});
+        }
+    }
+    
+    // Append recurring occurrences inside range, from the cache when it covers range
+    void recurring_windows(const CompactSlot& range, std::vector<CompactSlot>& out) const {
+        if (recurring->cache_horizon.contains(range)) {
+            clip_windows(recurring->cache, range, out);
+            return;
+        }
+        size_t first = out.size();
+        for (const RecurringAvailability& rule : recurring->rules) {
+            rule.expand(range, out);
+        }
+        if (recurring->rules.size() > 1) coalesce(out, first);
+    }
+
+public:
+    User(const std::string& name, const std::string& email, UserRole role)
+        : user_id(ids.next()), name(name), email(email), role(role) {}
+    
+    // Construct with an id reserved through id_generator()
+    User(int id, const std::string& name, const std::string& email, UserRole role)
+        : user_id(id), name(name), email(email), role(role) {}
+    
+    User(int id, InternedString name, InternedString email, UserRole role)
+        : user_id(id), name(name), email(email), role(role) {}
+    
+    static IdGenerator& id_generator() { return ids; }
+    
+    // Getters
+    int get_id() const { return user_id; }
+    const std::string& get_name() const { return name.str(); }
+    const std::string& get_email() const { return email.str(); }
+    UserRole get_role() const { return role; }
+    const IntervalSet& get_compact_availability() const { return availability; }
+    
+    // Availability converted back to system_clock slots
+    std::vector<TimeSlot> get_availability() const {
+        std::vector<TimeSlot> slots;
+        slots.reserve(availability.size());
+        for (size_t i = 0; i < availability.size(); ++i) {
+            slots.push_back(CompactTime::to_time_slot(availability[i]));
+        }
+        return slots;
+    }
+    const std::set<int>& get_scheduled_interviews() const { return scheduled_interviews; }
+    const BookingIndex& get_active_bookings() const { return active_bookings; }
+    const QuantumCalendar* get_calendar() const { return calendar.get(); }
+    bool has_recurring_availability() const { return recurring != nullptr; }
+    
+    const std::vector<RecurringAvailability>& get_recurring_availability() const {
+        static const std::vector<RecurringAvailability> none;
+        return recurring ? recurring->rules : none;
+    }
+    
+    // Availability windows inside range, clipped to it, sorted and coalesced:
+    // the explicit windows together with every recurring occurrence
+    void available_windows(const CompactSlot& range, std::vector<CompactSlot>& out) const {
+        size_t first = out.size();
+        clip_windows(availability, range, out);
+        if (recurring) {
+            recurring_windows(range, out);
+            coalesce(out, first);
+        }
+    }
+    
+    // Build the bitmap calendar over a horizon. Returns false, leaving the mode
+    // off, if any availability window or booking is not quantum-aligned.
+    bool enable_calendar(const CompactSlot& horizon) {
+        std::unique_ptr<QuantumCalendar> built(new QuantumCalendar(horizon));
+        for (size_t i = 0; i < availability.size(); ++i) {
+            if (!QuantumCalendar::is_aligned(availability[i])) return false;
+            built->mark_available(availability[i]);
+        }
+        if (recurring) {
+            std::vector<CompactSlot> occurrences;
+            recurring_windows(horizon, occurrences);
+            for (const CompactSlot& occurrence : occurrences) {
+                if (!QuantumCalendar::is_aligned(occurrence)) return false;
+                built->mark_available(occurrence);
+            }
+        }
+        for (size_t i = 0; i < active_bookings.size(); ++i) {
+            CompactSlot booking{active_bookings.start(i), active_bookings.end(i)};
+            if (!QuantumCalendar::is_aligned(booking)) return false;
+            built->set_busy(booking, true);
+        }
+        calendar = std::move(built);
+        return true;
+    }
+    
+    void disable_calendar() { calendar.reset(); }
+    
+    // Add availability slot, merging it with any windows it overlaps or touches
+    // so that availability stays sorted by start time and non-overlapping.
+    // Throws std::runtime_error if the slot is outside CompactTime's range.
+    void add_availability(const TimeSlot& slot) {
+        check_in_range(slot);
+        CompactSlot merged = availability.add(CompactTime::to_compact_within(slot));
+        drop_calendar_if_unaligned(merged);
+        if (calendar) calendar->mark_available(merged);
+    }
+    
+    // Add many availability slots at once with a single sort and merge pass
+    void add_availability(const std::vector<TimeSlot>& slots) {
+        for (const auto& slot : slots) {
+            check_in_range(slot);
+        }
+        std::vector<CompactSlot> compact;
+        compact.reserve(slots.size());
+        for (const auto& slot : slots) {
+            compact.push_back(CompactTime::to_compact_within(slot));
+        }
+        add_compact_availability(std::move(compact));
+    }
+    
+    void add_compact_availability(std::vector<CompactSlot> slots) {
+        availability.add(std::move(slots));
+        if (calendar && !enable_calendar(calendar->horizon())) calendar.reset();
+    }
+    
+    // Add a weekly rule. Its occurrences count as availability wherever they
+    // fall, on top of the explicit windows. A rule the user already has is
+    // ignored, so log replay over a snapshot does not duplicate rules.
+    void add_recurring_availability(RecurringAvailability rule) {
+        if (!recurring) recurring.reset(new RecurringState());
+        if (std::find(recurring->rules.begin(), recurring->rules.end(), rule) != recurring->rules.end()) return;
+        recurring->rules.push_back(std::move(rule));
+        if (recurring->cache_horizon.start < recurring->cache_horizon.end) {
+            cache_recurring_availability(recurring->cache_horizon);
+        }
+        if (calendar && !enable_calendar(calendar->horizon())) calendar.reset();
+    }
+    
+    // Expand the rules over a horizon once, so queries inside it read the
+    // expanded windows instead of walking the weeks. Kept up to date as rules
+    // are added. Returns false if the user has no rules.
+    bool cache_recurring_availability(const CompactSlot& horizon) {
+        if (!recurring) return false;
+        std::vector<CompactSlot> occurrences;
+        recurring->cache_horizon = CompactSlot{0, 0};
+        recurring_windows(horizon, occurrences);
+        recurring->cache = IntervalSet();
+        recurring->cache.add(std::move(occurrences));
+        recurring->cache_horizon = horizon;
+        return true;
+    }
+    
+    // Replace availability with windows read from a snapshot. They must be
+    // sorted and coalesced, as get_compact_availability() returns them.
+    bool load_availability(const uint32_t* starts, const uint32_t* ends, size_t count) {
+        calendar.reset();
+        return availability.assign_sorted(starts, ends, count);
+    }
+    
+    // Check if user is available during a time slot
+    bool is_available(const TimeSlot& slot) const {
+        return is_available(CompactTime::to_compact(slot));
+    }
+    
+    bool is_available(const CompactSlot& slot) const {
+        if (calendar && calendar->covers(slot)) return calendar->is_available(slot);
+        if (availability.contains(slot)) return true;
+        if (!recurring || slot.start >= slot.end) return false;
+        
+        // Explicit and recurring windows may cover the slot only together
+        std::vector<CompactSlot> windows;
+        available_windows(slot, windows);
+        return windows.size() == 1 && windows[0].start == slot.start && windows[0].end == slot.end;
+    }
+    
+    // Add scheduled interview
+    void add_scheduled_interview(int interview_id) {
+        // Ids are normally increasing, so hint at the back
+        scheduled_interviews.insert(scheduled_interviews.end(), interview_id);
+    }
+    
+    // Remove scheduled interview
+    void remove_scheduled_interview(int interview_id) {
+        scheduled_interviews.erase(interview_id);
+    }
+    
+    // Track an active booking in the conflict index
+    void add_active_booking(int interview_id, const TimeSlot& slot) {
+        CompactSlot compact = CompactTime::to_compact(slot);
+        active_bookings.insert(interview_id, compact);
+        drop_calendar_if_unaligned(compact);
+        if (calendar) calendar->set_busy(compact, true);
+    }
+    
+    // Drop a booking from the conflict index once it is no longer active
+    void remove_active_booking(int interview_id, const TimeSlot& slot) {
+        CompactSlot compact = CompactTime::to_compact(slot);
+        active_bookings.erase(interview_id, compact);
+        // Aligned bookings never share a quantum, so clearing is exact
+        if (calendar) calendar->set_busy(compact, false);
+    }
+    
+    // Check if a time slot overlaps any of the user's active bookings
+    bool has_booking_conflict(const TimeSlot& slot, int ignore_interview_id = 0) const {
+        return active_bookings.overlaps(CompactTime::to_compact(slot), ignore_interview_id);
+    }
+    
+    bool has_booking_conflict(const CompactSlot& slot, int ignore_interview_id = 0) const {
+        if (ignore_interview_id == 0 && calendar && calendar->covers(slot)) {
+            CLOUDFIT_COUNT_SCAN(0);
+            return calendar->is_busy(slot);
+        }
+        return active_bookings.overlaps(slot, ignore_interview_id);
+    }
+    
+    std::string role_to_string() const {
+        return (role == UserRole::HR_MANAGER) ? "HR Manager" : "Interviewer";
+    }
+};
+
+IdGenerator User::ids(1);
+
+// Interview class
+class Interview {
+private:
+    static IdGenerator ids;
+    int interview_id;
+    InternedString candidate_name;
+    InternedString position;
+    int hr_manager_id;
+    int interviewer_id;
+    TimeSlot time_slot;
+    InterviewStatus status;
+    std::string notes;
+
+public:
+    Interview(const std::string& candidate, const std::string& pos, 
+              int hr_id, int int_id, const TimeSlot& slot)
+        : interview_id(ids.next()), candidate_name(candidate), position(pos),
+          hr_manager_id(hr_id), interviewer_id(int_id), time_slot(slot),
+          status(InterviewStatus::SCHEDULED) {}
+    
+    // Construct with an id reserved through id_generator()
+    Interview(int id, const std::string& candidate, const std::string& pos,
+              int hr_id, int int_id, const TimeSlot& slot)
+        : interview_id(id), candidate_name(candidate), position(pos),
+          hr_manager_id(hr_id), interviewer_id(int_id), time_slot(slot),
+          status(InterviewStatus::SCHEDULED) {}
+    
+    Interview(int id, InternedString candidate, InternedString pos,
+              int hr_id, int int_id, const TimeSlot& slot)
+        : interview_id(id), candidate_name(candidate), position(pos),
+          hr_manager_id(hr_id), interviewer_id(int_id), time_slot(slot),
+          status(InterviewStatus::SCHEDULED) {}
+    
+    static IdGenerator& id_generator() { return ids; }
+    
+    // Getters
+    int get_id() const { return interview_id; }
+    const std::string& get_candidate_name() const { return candidate_name.str(); }
+    const std::string& get_position() const { return position.str(); }
+    InternedString get_position_key() const { return position; }
+    int get_hr_manager_id() const { return hr_manager_id; }
+    int get_interviewer_id() const { return interviewer_id; }
+    const TimeSlot& get_time_slot() const { return time_slot; }
+    InterviewStatus get_status() const { return status; }
+    const std::string& get_notes() const { return notes; }
+    
+    // Setters
+    void set_status(InterviewStatus new_status) { status = new_status; }
+    void set_notes(const std::string& new_notes) { notes = new_notes; }
+    void set_time_slot(const TimeSlot& new_slot) { time_slot = new_slot; }
+    
+    // Scheduled and rescheduled interviews still occupy their time slot
+    bool is_active() const {
+        return status == InterviewStatus::SCHEDULED || status == InterviewStatus::RESCHEDULED;
+    }
+    
+    std::string status_to_string() const {
+        switch (status) {
+            case InterviewStatus::SCHEDULED: return "Scheduled";
+            case InterviewStatus::COMPLETED: return "Completed";
+            case InterviewStatus::CANCELLED: return "Cancelled";
+            case InterviewStatus::RESCHEDULED: return "Rescheduled";
+            default: return "Unknown";
+        }
+    }
+};
+
+IdGenerator Interview::ids(1);
+
+// Chunked object pool. Objects are placed into fixed-size chunks that never
+// move, so a handle (slot index) and the object's address stay valid until the
+// object is destroyed. Freed slots are reused before new ones are taken.
+template <typename T, size_t ChunkSize = 1024>
+class SlabPool {
+private:
+    struct Chunk {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type slots[ChunkSize];
+    };
+    
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    std::vector<bool> live;
+    std::vector<size_t> free_handles;
+    size_t live_count = 0;
+    
+    // (address, index) of every chunk, sorted by address, for handle_of()
+    std::vector<std::pair<const Chunk*, size_t>> chunk_order;
+    
+    T* slot(size_t handle) const {
+        return reinterpret_cast<T*>(&chunks[handle / ChunkSize]->slots[handle % ChunkSize]);
+    }
+
+public:
+    SlabPool() = default;
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+    
+    ~SlabPool() {
+        for (size_t handle = 0; handle < live.size(); ++handle) {
+            if (live[handle]) slot(handle)->~T();
+        }
+    }
+    
+    // Construct a new object in the pool and return its handle
+    template <typename... Args>
+    size_t create(Args&&... args) {
+        size_t handle;
+        if (!free_handles.empty()) {
+            handle = free_handles.back();
+            free_handles.pop_back();
+        } else {
+            handle = live.size();
+            if (handle % ChunkSize == 0) {
+                chunks.push_back(std::make_unique<Chunk>());
+                std::pair<const Chunk*, size_t> entry(chunks.back().get(), chunks.size() - 1);
+                chunk_order.insert(std::upper_bound(chunk_order.begin(), chunk_order.end(), entry,
+                                                    [](const std::pair<const Chunk*, size_t>& a,
+                                                       const std::pair<const Chunk*, size_t>& b) {
+                                                        return std::less<const Chunk*>()(a.first, b.first);
+                                                    }),
+                                   entry);
+            }
+            live.push_back(false);
+        }
+        
+        try {
+            new (slot(handle)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            free_handles.push_back(handle);
+            throw;
+        }
+        live[handle] = true;
+        ++live_count;
+        return handle;
+    }
+    
+    // Destroy the object behind a handle and make the slot reusable
+    void destroy(size_t handle) {
+        if (handle >= live.size() || !live[handle]) return;
+        slot(handle)->~T();
+        live[handle] = false;
+        free_handles.push_back(handle);
+        --live_count;
+    }
+    
+    T* get(size_t handle) const {
+        return (handle < live.size() && live[handle]) ? slot(handle) : nullptr;
+    }
+    
+    // Handle of an object created by this pool
+    size_t handle_of(const T* object) const {
+        const Chunk* address = reinterpret_cast<const Chunk*>(object);
+        auto it = std::upper_bound(chunk_order.begin(), chunk_order.end(), address,
+                                   [](const Chunk* a, const std::pair<const Chunk*, size_t>& b) {
+                                       return std::less<const Chunk*>()(a, b.first);
+                                   });
+        if (it == chunk_order.begin()) return live.size();
+        --it;
+        size_t offset = static_cast<size_t>(reinterpret_cast<const char*>(object) -
+                                            reinterpret_cast<const char*>(it->first->slots));
+        if (offset >= sizeof(it->first->slots)) return live.size();
+        return it->second * ChunkSize + offset / sizeof(it->first->slots[0]);
+    }
+    
+    size_t size() const { return live_count; }
+    
+    // Visit live objects in slot order, chunk by chunk
+    template <typename Fn>
+    void for_each(Fn fn) const {
+        for (size_t handle = 0; handle < live.size(); ++handle) {
+            if (live[handle]) fn(slot(handle));
+        }
+    }
+};
+
+// Directly indexed id -> object table. Ids are handed out densely from a
+// counter, so a vector gives O(1) lookups; removed ids leave a null tombstone.
+template <typename T>
+class DenseIdTable {
+private:
+    std::vector<T*> slots;
+    size_t live_count = 0;
+
+public:
+    // Size the table for ids up to max_id ahead of a bulk load
+    void reserve(int max_id) {
+        if (max_id > 0 && static_cast<size_t>(max_id) >= slots.size()) {
+            slots.resize(static_cast<size_t>(max_id) + 1, nullptr);
+        }
+    }
+    
+    void insert(int id, T* object) {
+        if (id <= 0) return;
+        size_t index = static_cast<size_t>(id);
+        if (index >= slots.size()) {
+            slots.resize(index + 1, nullptr);
+        }
+        if (!slots[index]) ++live_count;
+        slots[index] = object;
+    }
+    
+    void erase(int id) {
+        if (id <= 0 || static_cast<size_t>(id) >= slots.size() || !slots[id]) return;
+        slots[id] = nullptr;
+        --live_count;
+    }
+    
+    T* get(int id) const {
+        return (id > 0 && static_cast<size_t>(id) < slots.size()) ? slots[id] : nullptr;
+    }
+    
+    size_t size() const { return live_count; }
+    
+    // Visit live entries in id order
+    template <typename Fn>
+    void for_each(Fn fn) const {
+        for (T* object : slots) {
+            if (object) fn(object);
+        }
+    }
+};
+
+// Interviews ordered by start time, one ordered set per status, so calendar
+// views and reminder dispatch cost O(log n + output). The longest interview
+// seen bounds how far before the query start an overlapping one can begin.
+// The index has its own lock and never calls out while holding it.
+class TimeRangeIndex {
+private:
+    struct Entry {
+        uint32_t start;
+        uint32_t end;
+        int interview_id;
+        Interview* interview;
+        
+        bool operator<(const Entry& other) const {
+            return start < other.start || (start == other.start && interview_id < other.interview_id);
+        }
+    };
+    
+    static const size_t STATUS_COUNT = 4;
+    
+    std::set<Entry> by_status[STATUS_COUNT];
+    uint32_t max_duration = 0;
+    mutable std::shared_timed_mutex mutex;
+    
+    static Entry make_entry(Interview* interview) {
+        CompactSlot slot = CompactTime::to_compact(interview->get_time_slot());
+        return Entry{slot.start, slot.end, interview->get_id(), interview};
+    }
+    
+    // Append the entries of one status that overlap [start, end)
+    void collect(size_t status, const CompactSlot& range, std::vector<Entry>& out) const {
+        const std::set<Entry>& entries = by_status[status];
+        uint32_t earliest = range.start > max_duration ? range.start - max_duration : 0;
+        Entry probe{earliest, earliest, 0, nullptr};
+        for (auto it = entries.lower_bound(probe); it != entries.end() && it->start < range.end; ++it) {
+            if (it->end > range.start) out.push_back(*it);
+        }
+    }
+    
+    static std::vector<Interview*> to_interviews(const std::vector<Entry>& entries) {
+        std::vector<Interview*> result;
+        result.reserve(entries.size());
+        for (const Entry& entry : entries) {
+            result.push_back(entry.interview);
+        }
+        return result;
+    }
+
+public:
+    // Index an interview under its current status and time slot
+    void insert(Interview* interview) {
+        std::unique_lock<std::shared_timed_mutex> lock(mutex);
+        Entry entry = make_entry(interview);
+        max_duration = std::max(max_duration, entry.end - entry.start);
+        
+        // Hinted at the back: bulk loads arrive in start-time order
+        std::set<Entry>& entries = by_status[static_cast<size_t>(interview->get_status())];
+        entries.insert(entries.end(), entry);
+    }
+    
+    // Remove an interview using its current status and time slot
+    void erase(Interview* interview) {
+        std::unique_lock<std::shared_timed_mutex> lock(mutex);
+        by_status[static_cast<size_t>(interview->get_status())].erase(make_entry(interview));
+    }
+    
+    // Interviews of any status overlapping [start, end), ordered by start time
+    std::vector<Interview*> query(const std::chrono::system_clock::time_point& start,
+                                  const std::chrono::system_clock::time_point& end) const {
+        CompactSlot range = CompactTime::to_compact(TimeSlot(start, end));
+        std::vector<Entry> entries;
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(mutex);
+            for (size_t status = 0; status < STATUS_COUNT; ++status) {
+                size_t mid = entries.size();
+                collect(status, range, entries);
+                std::inplace_merge(entries.begin(), entries.begin() + mid, entries.end());
+            }
+        }
+        return to_interviews(entries);
+    }
+    
+    // Up to limit interviews with the given status that ended by horizon,
+    // earliest start first
+    std::vector<Interview*> ended_before(const std::chrono::system_clock::time_point& horizon,
+                                         InterviewStatus status, size_t limit) const {
+        uint32_t last_start = CompactTime::to_minutes(horizon);
+        std::vector<Interview*> result;
+        std::shared_lock<std::shared_timed_mutex> lock(mutex);
+        for (const Entry& entry : by_status[static_cast<size_t>(status)]) {
+            if (entry.start > last_start || result.size() >= limit) break;
+            if (entry.interview->get_time_slot().end_time <= horizon) result.push_back(entry.interview);
+        }
+        return result;
+    }
+    
+    // Interviews with the given status overlapping [start, end)
+    std::vector<Interview*> query(const std::chrono::system_clock::time_point& start,
+                                  const std::chrono::system_clock::time_point& end,
+                                  InterviewStatus status) const {
+        CompactSlot range = CompactTime::to_compact(TimeSlot(start, end));
+        std::vector<Entry> entries;
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(mutex);
+            collect(static_cast<size_t>(status), range, entries);
+        }
+        return to_interviews(entries);
+    }
+};
+
+// Filter for InterviewHotTable::select. Zero ids and a null position match
+// everything; status_mask has bit (1 << status) set for each wanted status.
+struct InterviewQuery {
+    int hr_manager_id = 0;
+    int interviewer_id = 0;
+    uint8_t status_mask = 0x0F;
+    CompactSlot range = CompactSlot{0, std::numeric_limits<uint32_t>::max()};
+    const InternedString* position = nullptr;
+};
+
+// Hot fields of every interview in structure-of-arrays form, indexed by
+// interview id: participants, compact slot, status and the position handle.
+// Whole-collection filters scan these packed columns and never touch the
+// Interview objects, which keep the strings and notes for display. Rows are
+// written wherever the Scheduler changes those fields; like TimeRangeIndex
+// the table has its own lock and calls out to nothing while holding it.
+class InterviewHotTable {
+private:
+    static const uint8_t EMPTY = 0xFF;
+    
+    std::vector<int32_t> hr_manager_ids;
+    std::vector<int32_t> interviewer_ids;
+    std::vector<uint32_t> starts;
+    std::vector<uint32_t> ends;
+    std::vector<uint8_t> statuses;
+    std::vector<const std::string*> positions;
+    mutable std::shared_timed_mutex mutex;
+    
+    void grow(size_t index) {
+        if (index < statuses.size()) return;
+        size_t size = std::max(index + 1, statuses.size() * 2);
+        hr_manager_ids.resize(size, 0);
+        interviewer_ids.resize(size, 0);
+        starts.resize(size, 0);
+        ends.resize(size, 0);
+        statuses.resize(size, EMPTY);
+        positions.resize(size, nullptr);
+    }
+
+public:
+    // Size the columns for ids up to max_id ahead of a bulk load
+    void reserve(int max_id) {
+        std::unique_lock<std::shared_timed_mutex> lock(mutex);
+        if (max_id > 0) grow(static_cast<size_t>(max_id));
+    }
+    
+    // Copy all hot fields of an interview into its row
+    void update(const Interview* interview) {
+        CompactSlot slot = CompactTime::to_compact(interview->get_time_slot());
+        size_t index = static_cast<size_t>(interview->get_id());
+        std::unique_lock<std::shared_timed_mutex> lock(mutex);
+        grow(index);
+        hr_manager_ids[index] = interview->get_hr_manager_id();
+        interviewer_ids[index] = interview->get_interviewer_id();
+        starts[index] = slot.start;
+        ends[index] = slot.end;
+        statuses[index] = static_cast<uint8_t>(interview->get_status());
+        positions[index] = &interview->get_position();
+    }
+    
+    void set_status(int interview_id, InterviewStatus status) {
+        std::unique_lock<std::shared_timed_mutex> lock(mutex);
+        if (static_cast<size_t>(interview_id) < statuses.size()) {
+            statuses[interview_id] = static_cast<uint8_t>(status);
+        }
+    }
+    
+    void set_slot(int interview_id, const CompactSlot& slot) {
+        std::unique_lock<std::shared_timed_mutex> lock(mutex);
+        if (static_cast<size_t>(interview_id) < statuses.size()) {
+            starts[interview_id] = slot.start;
+            ends[interview_id] = slot.end;
+        }
+    }
+    
+    // Empty a row, e.g. once its interview is archived
+    void erase(int interview_id) {
+        std::unique_lock<std::shared_timed_mutex> lock(mutex);
+        if (static_cast<size_t>(interview_id) < statuses.size()) {
+            statuses[interview_id] = EMPTY;
+            positions[interview_id] = nullptr;
+        }
+    }
+    
+    // Visit the id of every matching row, in id order
+    template <typename Fn>
+    void scan(const InterviewQuery& query, Fn fn) const {
+        const std::string* position = query.position ? &query.position->str() : nullptr;
+        std::shared_lock<std::shared_timed_mutex> lock(mutex);
+        for (size_t i = 1; i < statuses.size(); ++i) {
+            uint8_t status = statuses[i];
+            if (status == EMPTY || !((query.status_mask >> status) & 1)) continue;
+            if (starts[i] >= query.range.end || ends[i] <= query.range.start) continue;
+            if (query.hr_manager_id && hr_manager_ids[i] != query.hr_manager_id) continue;
+            if (query.interviewer_id && interviewer_ids[i] != query.interviewer_id) continue;
+            if (position && positions[i] != position) continue;
+            fn(static_cast<int>(i));
+        }
+    }
+    
+    std::vector<int> select(const InterviewQuery& query) const {
+        std::vector<int> ids;
+        scan(query, [&ids](int id) { ids.push_back(id); });
+        return ids;
+    }
+    
+    size_t count(const InterviewQuery& query) const {
+        size_t matches = 0;
+        scan(query, [&matches](int) { ++matches; });
+        return matches;
+    }
+};
+
+const uint8_t InterviewHotTable::EMPTY;
+
+// Enum for scheduling outcomes
+enum class ScheduleError {
+    NONE,
+    INVALID_USER,
+    NOT_HR_MANAGER,
+    NOT_INTERVIEWER,
+    HR_MANAGER_UNAVAILABLE,
+    INTERVIEWER_UNAVAILABLE,
+    TIME_CONFLICT,
+    BATCH_CONFLICT,     // Overlaps an earlier-starting request in the same batch
+    BATCH_ABORTED,      // Valid, but not committed because another request failed
+    NO_FEASIBLE_LOOP,   // No start time and interviewer choice fits every round
+    BATCH_FAILED,       // The batch threw, e.g. out of memory; nothing was booked
+    OUT_OF_RANGE,       // Before the CompactTime epoch or past its last minute
+    INVALID_INTERVIEW   // No such interview, or it is no longer active
+};
+
+// Number of ScheduleError values; follows the last enumerator
+const size_t SCHEDULE_ERROR_COUNT = static_cast<size_t>(ScheduleError::INVALID_INTERVIEW) + 1;
+
+// Human-readable message for a scheduling outcome
+const char* schedule_error_to_string(ScheduleError error) {
+    switch (error) {
+        case ScheduleError::NONE: return "Success";
+        case ScheduleError::INVALID_USER: return "Invalid user ID";
+        case ScheduleError::NOT_HR_MANAGER: return "User is not an HR manager";
+        case ScheduleError::NOT_INTERVIEWER: return "User is not an interviewer";
+        case ScheduleError::HR_MANAGER_UNAVAILABLE: return "HR manager is not available at this time";
+        case ScheduleError::INTERVIEWER_UNAVAILABLE: return "Interviewer is not available at this time";
+        case ScheduleError::TIME_CONFLICT: return "Time slot conflicts with existing interview";
+        case ScheduleError::BATCH_CONFLICT: return "Time slot conflicts with another request in the batch";
+        case ScheduleError::BATCH_ABORTED: return "Batch aborted because another request failed";
+        case ScheduleError::NO_FEASIBLE_LOOP: return "No time in the window fits every round of the loop";
+        case ScheduleError::BATCH_FAILED: return "Batch failed before it could be booked";
+        case ScheduleError::OUT_OF_RANGE: return "Time is outside the range the scheduler can store";
+        case ScheduleError::INVALID_INTERVIEW: return "Interview does not exist or is not active";
+        default: return "Unknown error";
+    }
+}
+
+// Single booking request for batch scheduling
+struct ScheduleRequest {
+    std::string candidate_name;
+    std::string position;
+    int hr_manager_id;
+    int interviewer_id;
+    TimeSlot time_slot;
+};
+
+// Per-request outcome of a batch
+struct ScheduleResult {
+    ScheduleError error;
+    int interview_id;   // 0 unless error is NONE
+};
+
+// One side of a booking whose users live in different schedulers of a
+// ShardedScheduler. The interview belongs to the HR manager's scheduler;
+// the interviewer's scheduler only books the time as an external booking.
+struct BookingHold {
+    int interview_id;           // reserved from Interview::id_generator()
+    ScheduleRequest request;
+    bool owner_side;            // true on the HR manager's scheduler
+    int owner;                  // coordinator's index of the owning scheduler
+};
+
+// Second-phase outcome for a hold
+struct HoldDecision {
+    int interview_id;
+    bool commit;
+};
+
+// Interview of a local user that another scheduler owns
+struct ExternalInterview {
+    int interview_id;
+    int owner;
+};
+
+// Non-owning view over a contiguous run of users
+class UserSpan {
+private:
+    User* const* first;
+    User* const* last;
+
+public:
+    UserSpan(User* const* first, User* const* last) : first(first), last(last) {}
+    
+    User* const* begin() const { return first; }
+    User* const* end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+    User* operator[](size_t index) const { return first[index]; }
+};
+
+// Counters reported by Scheduler::get_statistics
+struct SchedulerStats {
+    size_t hr_managers;
+    size_t interviewers;
+    size_t scheduled;
+    size_t completed;
+    size_t cancelled;
+    size_t rescheduled;
+    
+    size_t total_users() const { return hr_managers + interviewers; }
+    size_t total_interviews() const { return scheduled + completed + cancelled + rescheduled; }
+};
+
+// Fixed run of interview versions, indexed by id modulo CHUNK_SIZE. Chunks
+// and the interviews in them are shared between the live version table and
+// every view taken from it, and copied before a write if shared.
+struct InterviewChunk {
+    static const size_t CHUNK_SIZE = 256;
+    std::array<std::shared_ptr<Interview>, CHUNK_SIZE> rows;
+};
+
+// Immutable point-in-time view of a scheduler's interviews, returned by
+// Scheduler::snapshot(). Holding one never blocks writers, and nothing in
+// it changes however long a report iterates.
+class SchedulerView {
+private:
+    std::vector<std::shared_ptr<const InterviewChunk>> chunks;
+    SchedulerStats stats;
+    
+    // Per-user lists, built on first use
+    mutable std::once_flag user_index_once;
+    mutable std::unordered_map<int, std::vector<const Interview*>> user_index;
+    
+    // Interviews by start time, then id, with the latest end time up to each
+    // position; built on first use
+    mutable std::once_flag time_order_once;
+    mutable std::vector<const Interview*> by_start;
+    mutable std::vector<std::chrono::system_clock::time_point> latest_end;
+
+public:
+    SchedulerView(const std::vector<std::shared_ptr<InterviewChunk>>& live_chunks, const SchedulerStats& stats)
+        : chunks(live_chunks.begin(), live_chunks.end()), stats(stats) {}
+    
+    size_t size() const { return stats.total_interviews(); }
+    const SchedulerStats& get_statistics() const { return stats; }
+    
+    const Interview* get_interview(int interview_id) const {
+        size_t chunk = static_cast<size_t>(interview_id) / InterviewChunk::CHUNK_SIZE;
+        if (interview_id <= 0 || chunk >= chunks.size() || !chunks[chunk]) return nullptr;
+        return chunks[chunk]->rows[static_cast<size_t>(interview_id) % InterviewChunk::CHUNK_SIZE].get();
+    }
+    
+    // Visit every interview in id order
+    template <typename Fn>
+    void for_each(Fn fn) const {
+        for (const std::shared_ptr<const InterviewChunk>& chunk : chunks) {
+            if (!chunk) continue;
+            for (const std::shared_ptr<Interview>& row : chunk->rows) {
+                if (row) fn(static_cast<const Interview*>(row.get()));
+            }
+        }
+    }
+    
+    std::vector<const Interview*> get_all_interviews() const {
+        std::vector<const Interview*> all_interviews;
+        all_interviews.reserve(size());
+        for_each([&](const Interview* interview) { all_interviews.push_back(interview); });
+        return all_interviews;
+    }
+    
+    // Interviews of a user in id order, leaving out cancelled ones like
+    // Scheduler::get_user_interviews. The first call indexes the whole view.
+    const std::vector<const Interview*>& get_user_interviews(int user_id) const {
+        static const std::vector<const Interview*> none;
+        std::call_once(user_index_once, [this]() {
+            for_each([this](const Interview* interview) {
+                if (interview->get_status() == InterviewStatus::CANCELLED) return;
+                user_index[interview->get_hr_manager_id()].push_back(interview);
+                user_index[interview->get_interviewer_id()].push_back(interview);
+            });
+        });
+        auto it = user_index.find(user_id);
+        return it == user_index.end() ? none : it->second;
+    }
+    
+    // Interviews overlapping [start, end), ordered by start time. The first
+    // call sorts the view once; later calls binary-search the latest end
+    // times for the first interview that can still overlap.
+    std::vector<const Interview*> interviews_in_range(const std::chrono::system_clock::time_point& start,
+                                                      const std::chrono::system_clock::time_point& end) const {
+        std::call_once(time_order_once, [this]() {
+            by_start = get_all_interviews();
+            std::stable_sort(by_start.begin(), by_start.end(), [](const Interview* a, const Interview* b) {
+                return a->get_time_slot().start_time < b->get_time_slot().start_time;
+            });
+            latest_end.reserve(by_start.size());
+            for (const Interview* interview : by_start) {
+                const auto& slot_end = interview->get_time_slot().end_time;
+                latest_end.push_back(latest_end.empty() ? slot_end : std::max(latest_end.back(), slot_end));
+            }
+        });
+        
+        std::vector<const Interview*> result;
+        size_t first = std::upper_bound(latest_end.begin(), latest_end.end(), start) - latest_end.begin();
+        for (size_t i = first; i < by_start.size() && by_start[i]->get_time_slot().start_time < end; ++i) {
+            if (start < by_start[i]->get_time_slot().end_time) result.push_back(by_start[i]);
+        }
+        return result;
+    }
+};
+
+// Copy-on-write versions of every interview, indexed by id in chunks.
+// Taking a view copies one pointer per chunk. A write copies its chunk if a
+// view still shares it, and replaces the interview instead of changing it
+// in place if an older chunk still holds it; unshared data is updated in
+// place, so writers pay for copies only while views are alive.
+class InterviewVersionTable {
+private:
+    std::vector<std::shared_ptr<InterviewChunk>> chunks;
+    size_t status_counts[4] = {};
+    std::atomic<bool> active{false};
+    mutable std::mutex mutex;
+
+public:
+    // Tracking starts when the scheduler first hands out a view
+    bool enabled() const { return active.load(std::memory_order_relaxed); }
+    void enable() { active.store(true, std::memory_order_relaxed); }
+    
+    // Record the current state of an interview
+    void update(const Interview* interview) {
+        size_t id = static_cast<size_t>(interview->get_id());
+        size_t chunk_index = id / InterviewChunk::CHUNK_SIZE;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (chunk_index >= chunks.size()) chunks.resize(chunk_index + 1);
+        
+        std::shared_ptr<InterviewChunk>& chunk = chunks[chunk_index];
+        if (!chunk) {
+            chunk = std::make_shared<InterviewChunk>();
+        } else if (chunk.use_count() > 1) {
+            chunk = std::make_shared<InterviewChunk>(*chunk);
+        } else {
+            // Views that released this chunk did so before the count dropped
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        
+        std::shared_ptr<Interview>& row = chunk->rows[id % InterviewChunk::CHUNK_SIZE];
+        if (row) --status_counts[static_cast<size_t>(row->get_status())];
+        if (row && row.use_count() == 1) {
+            // Views that released this row did so before the count dropped
+            std::atomic_thread_fence(std::memory_order_acquire);
+            *row = *interview;
+        } else {
+            row = std::make_shared<Interview>(*interview);
+        }
+        ++status_counts[static_cast<size_t>(interview->get_status())];
+    }
+    
+    // Drop an interview from later views; views already taken keep it
+    void erase(int interview_id) {
+        size_t id = static_cast<size_t>(interview_id);
+        size_t chunk_index = id / InterviewChunk::CHUNK_SIZE;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (chunk_index >= chunks.size() || !chunks[chunk_index]) return;
+        
+        std::shared_ptr<InterviewChunk>& chunk = chunks[chunk_index];
+        std::shared_ptr<Interview>& row = chunk->rows[id % InterviewChunk::CHUNK_SIZE];
+        if (!row) return;
+        --status_counts[static_cast<size_t>(row->get_status())];
+        if (chunk.use_count() > 1) {
+            chunk = std::make_shared<InterviewChunk>(*chunk);
+        } else {
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        chunk->rows[id % InterviewChunk::CHUNK_SIZE].reset();
+    }
+    
+    std::shared_ptr<const SchedulerView> view(size_t hr_managers, size_t interviewers) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        SchedulerStats stats;
+        stats.hr_managers = hr_managers;
+        stats.interviewers = interviewers;
+        stats.scheduled = status_counts[static_cast<size_t>(InterviewStatus::SCHEDULED)];
+        stats.completed = status_counts[static_cast<size_t>(InterviewStatus::COMPLETED)];
+        stats.cancelled = status_counts[static_cast<size_t>(InterviewStatus::CANCELLED)];
+        stats.rescheduled = status_counts[static_cast<size_t>(InterviewStatus::RESCHEDULED)];
+        return std::make_shared<const SchedulerView>(chunks, stats);
+    }
+};
+
+// Immutable, compressed run of archived interviews in start-time order.
+// Records are varint-encoded into one byte string: times as whole seconds
+// plus a sub-second remainder that is one byte when zero, ids and the
+// participants as deltas or small integers, and candidate, position and notes
+// as indexes into a per-segment string table. Every BLOCK_RECORDS-th record
+// is stored in full, and a block index over those records limits a lookup to
+// decoding one block; a sorted id list maps ids to records.
+class ArchiveSegment {
+public:
+    static const size_t BLOCK_RECORDS = 64;
+
+private:
+    std::string bytes;
+    std::vector<std::string> strings;
+    std::vector<uint32_t> block_offsets;    // into bytes
+    std::vector<int64_t> block_starts;      // start of each block's first record, in nanoseconds
+    std::vector<std::pair<int32_t, uint32_t>> by_id;   // (interview id, record index), sorted
+    size_t record_count = 0;
+    int64_t max_duration = 0;
+    int64_t last_end = std::numeric_limits<int64_t>::min();
+    size_t status_counts[4] = {};
+    bool subsecond = true;                  // false for segments of older snapshots, kept to the second
+    bool valid = true;
+    
+    static const int64_t NANOSECONDS = 1000000000;
+    static const int64_t MAX_SECONDS = std::numeric_limits<int64_t>::max() / NANOSECONDS - 1;
+    
+    // One record with its string fields still as table indexes. Times are
+    // nanoseconds since the Unix epoch.
+    struct Record {
+        int64_t start_seconds;
+        int64_t start;
+        int64_t end;
+        int64_t id;
+        uint64_t hr_manager_id;
+        uint64_t interviewer_id;
+        uint64_t status;
+        uint64_t candidate_name;
+        uint64_t position;
+        uint64_t notes;
+    };
+    
+    static void put_varint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+    
+    static bool get_varint(const char*& next, const char* end, uint64_t& value) {
+        value = 0;
+        for (unsigned shift = 0; shift < 64 && next < end; shift += 7) {
+            uint8_t byte = static_cast<uint8_t>(*next++);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+    
+    static uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+    
+    static int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+    
+    static int64_t to_nanoseconds(const std::chrono::system_clock::time_point& time) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+    
+    static std::chrono::system_clock::time_point from_nanoseconds(int64_t value) {
+        return std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(value)));
+    }
+    
+    // Whole seconds, rounded down, and the nanoseconds past them
+    static int64_t split_seconds(int64_t nanoseconds, uint64_t& remainder) {
+        int64_t seconds = nanoseconds / NANOSECONDS;
+        if (nanoseconds % NANOSECONDS < 0) --seconds;
+        remainder = static_cast<uint64_t>(nanoseconds - seconds * NANOSECONDS);
+        return seconds;
+    }
+    
+    // Decode the record at next. Block heads are absolute; the rest are
+    // deltas from previous, the record before it in the same block.
+    bool decode(const char*& next, bool block_head, Record& record) const {
+        const char* end = bytes.data() + bytes.size();
+        uint64_t start, start_rest = 0, duration, end_rest = 0, id;
+        if (!get_varint(next, end, start) || (subsecond && !get_varint(next, end, start_rest)) ||
+            !get_varint(next, end, duration) || (subsecond && !get_varint(next, end, end_rest)) ||
+            !get_varint(next, end, id) ||
+            !get_varint(next, end, record.hr_manager_id) || !get_varint(next, end, record.interviewer_id) ||
+            !get_varint(next, end, record.status) || !get_varint(next, end, record.candidate_name) ||
+            !get_varint(next, end, record.position) || !get_varint(next, end, record.notes)) {
+            return false;
+        }
+        record.start_seconds = block_head ? unzigzag(start) : record.start_seconds + static_cast<int64_t>(start);
+        int64_t end_seconds = record.start_seconds + unzigzag(duration);
+        if (record.start_seconds < -MAX_SECONDS || record.start_seconds > MAX_SECONDS ||
+            end_seconds < -MAX_SECONDS || end_seconds > MAX_SECONDS ||
+            start_rest >= static_cast<uint64_t>(NANOSECONDS) || end_rest >= static_cast<uint64_t>(NANOSECONDS)) {
+            return false;
+        }
+        record.start = record.start_seconds * NANOSECONDS + static_cast<int64_t>(start_rest);
+        record.end = end_seconds * NANOSECONDS + static_cast<int64_t>(end_rest);
+        record.id = block_head ? unzigzag(id) : record.id + unzigzag(id);
+        return record.id > 0 && record.id <= std::numeric_limits<int32_t>::max() &&
+               record.status <= static_cast<uint64_t>(InterviewStatus::RESCHEDULED) &&
+               record.candidate_name < strings.size() && record.position < strings.size() &&
+               record.notes < strings.size();
+    }
+    
+    Interview to_interview(const Record& record) const {
+        Interview interview(static_cast<int>(record.id), strings[record.candidate_name], strings[record.position],
+                            static_cast<int>(record.hr_manager_id), static_cast<int>(record.interviewer_id),
+                            TimeSlot(from_nanoseconds(record.start), from_nanoseconds(record.end)));
+        interview.set_status(static_cast<InterviewStatus>(record.status));
+        interview.set_notes(strings[record.notes]);
+        return interview;
+    }
+    
+    // Decode every record once to build the block index and id list
+    void build_index() {
+        const char* next = bytes.data();
+        Record record = Record();
+        for (size_t i = 0; i < record_count; ++i) {
+            bool block_head = i % BLOCK_RECORDS == 0;
+            if (block_head) block_offsets.push_back(static_cast<uint32_t>(next - bytes.data()));
+            if (!decode(next, block_head, record) || (!block_head && record.start < block_starts.back())) {
+                valid = false;
+                return;
+            }
+            if (block_head) block_starts.push_back(record.start);
+            max_duration = std::max(max_duration, record.end - record.start);
+            last_end = std::max(last_end, record.end);
+            ++status_counts[record.status];
+            by_id.push_back(std::make_pair(static_cast<int32_t>(record.id), static_cast<uint32_t>(i)));
+        }
+        valid = next == bytes.data() + bytes.size();
+        std::sort(by_id.begin(), by_id.end());
+        for (size_t i = 1; i < by_id.size() && valid; ++i) {
+            valid = by_id[i - 1].first != by_id[i].first;
+        }
+    }
+
+public:
+    // Encode interviews sorted by start time
+    explicit ArchiveSegment(const std::vector<Interview>& sorted) : record_count(sorted.size()) {
+        std::unordered_map<std::string, uint64_t> string_ids;
+        auto intern = [&](const std::string& value) {
+            auto it = string_ids.emplace(value, strings.size());
+            if (it.second) strings.push_back(value);
+            return it.first->second;
+        };
+        
+        int64_t previous_start = 0;
+        int64_t previous_id = 0;
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            const Interview& interview = sorted[i];
+            uint64_t start_rest, end_rest;
+            int64_t start = split_seconds(to_nanoseconds(interview.get_time_slot().start_time), start_rest);
+            int64_t end = split_seconds(to_nanoseconds(interview.get_time_slot().end_time), end_rest);
+            bool block_head = i % BLOCK_RECORDS == 0;
+            put_varint(bytes, block_head ? zigzag(start) : static_cast<uint64_t>(start - previous_start));
+            put_varint(bytes, start_rest);
+            put_varint(bytes, zigzag(end - start));
+            put_varint(bytes, end_rest);
+            put_varint(bytes, zigzag(block_head ? interview.get_id() : interview.get_id() - previous_id));
+            put_varint(bytes, static_cast<uint32_t>(interview.get_hr_manager_id()));
+            put_varint(bytes, static_cast<uint32_t>(interview.get_interviewer_id()));
+            put_varint(bytes, static_cast<uint64_t>(interview.get_status()));
+            put_varint(bytes, intern(interview.get_candidate_name()));
+            put_varint(bytes, intern(interview.get_position()));
+            put_varint(bytes, intern(interview.get_notes()));
+            previous_start = start;
+            previous_id = interview.get_id();
+        }
+        bytes.shrink_to_fit();
+        build_index();
+    }
+    
+    // Segment read back from a snapshot; check intact() before using it.
+    // Snapshots before version 5 kept times to the second.
+    ArchiveSegment(size_t record_count, std::string encoded, std::vector<std::string> string_table,
+                   bool subsecond)
+        : bytes(std::move(encoded)), strings(std::move(string_table)), record_count(record_count),
+          subsecond(subsecond) {
+        build_index();
+    }
+    
+    bool intact() const { return valid; }
+    size_t size() const { return record_count; }
+    const std::string& get_bytes() const { return bytes; }
+    const std::vector<std::string>& get_strings() const { return strings; }
+    size_t status_count(InterviewStatus status) const { return status_counts[static_cast<size_t>(status)]; }
+    int min_id() const { return by_id.empty() ? 0 : by_id.front().first; }
+    int max_id() const { return by_id.empty() ? 0 : by_id.back().first; }
+    
+    // Bytes held, including the string table and indexes
+    size_t memory_usage() const {
+        size_t total = bytes.size() + block_offsets.size() * sizeof(uint32_t) +
+                       block_starts.size() * sizeof(int64_t) + by_id.size() * sizeof(by_id[0]);
+        for (const std::string& value : strings) {
+            total += value.size();
+        }
+        return total;
+    }
+    
+    bool contains(int interview_id) const {
+        auto it = std::lower_bound(by_id.begin(), by_id.end(), std::make_pair(static_cast<int32_t>(interview_id), 0u));
+        return it != by_id.end() && it->first == interview_id;
+    }
+    
+    // Decoded copy of one interview, or null
+    std::unique_ptr<Interview> get(int interview_id) const {
+        auto it = std::lower_bound(by_id.begin(), by_id.end(), std::make_pair(static_cast<int32_t>(interview_id), 0u));
+        if (it == by_id.end() || it->first != interview_id) return nullptr;
+        
+        size_t block = it->second / BLOCK_RECORDS;
+        const char* next = bytes.data() + block_offsets[block];
+        Record record = Record();
+        for (size_t i = block * BLOCK_RECORDS; i <= it->second; ++i) {
+            decode(next, i % BLOCK_RECORDS == 0, record);
+        }
+        return std::unique_ptr<Interview>(new Interview(to_interview(record)));
+    }
+    
+    // Append decoded copies of the interviews overlapping [start, end), in start order
+    void in_range(const std::chrono::system_clock::time_point& start,
+                  const std::chrono::system_clock::time_point& end, std::vector<Interview>& out) const {
+        int64_t from = to_nanoseconds(start);
+        int64_t to = to_nanoseconds(end);
+        if (record_count == 0 || from >= last_end || to <= block_starts.front()) return;
+        
+        int64_t earliest = from - max_duration;
+        size_t block = std::upper_bound(block_starts.begin(), block_starts.end(), earliest) - block_starts.begin();
+        if (block > 0) --block;
+        const char* next = bytes.data() + block_offsets[block];
+        Record record = Record();
+        for (size_t i = block * BLOCK_RECORDS; i < record_count; ++i) {
+            decode(next, i % BLOCK_RECORDS == 0, record);
+            if (record.start >= to) break;
+            if (record.end > from) out.push_back(to_interview(record));
+        }
+    }
+    
+    // Visit decoded copies of every interview, in start order
+    template <typename Fn>
+    void for_each(Fn fn) const {
+        const char* next = bytes.data();
+        Record record = Record();
+        for (size_t i = 0; i < record_count; ++i) {
+            decode(next, i % BLOCK_RECORDS == 0, record);
+            fn(to_interview(record));
+        }
+    }
+};
+
+// Read-only store of finished interviews that left the live tables, as a
+// list of immutable segments. Only the archiving scheduler appends; readers
+// share the lock with it only while walking the segment list. Small
+// segments are merged with the next batch until they reach half of
+// SEGMENT_RECORDS, so frequent small archive runs do not fragment it.
+class InterviewArchive {
+public:
+    static const size_t SEGMENT_RECORDS = 4096;
+
+private:
+    std::vector<std::shared_ptr<const ArchiveSegment>> segments;
+    size_t record_count = 0;
+    mutable std::shared_timed_mutex mutex;
+    
+    static bool earlier(const Interview& a, const Interview& b) {
+        const TimeSlot& x = a.get_time_slot();
+        const TimeSlot& y = b.get_time_slot();
+        return x.start_time < y.start_time || (x.start_time == y.start_time && a.get_id() < b.get_id());
+    }
+
+public:
+    size_t size() const {
+        std::shared_lock<std::shared_timed_mutex> lock(mutex);
+        return record_count;
+    }
+    
+    size_t segment_count() const {
+        std::shared_lock<std::shared_timed_mutex> lock(mutex);
+        return segments.size();
+    }
+    
+    size_t memory_usage() const {
+        std::shared_lock<std::shared_timed_mutex> lock(mutex);
+        size_t total = 0;
+        for (const std::shared_ptr<const ArchiveSegment>& segment : segments) {
+            total += segment->memory_usage();
+        }
+        return total;
+    }
+    
+    std::vector<std::shared_ptr<const ArchiveSegment>> get_segments() const {
+        std::shared_lock<std::shared_timed_mutex> lock(mutex);
+        return segments;
+    }
+    
+    // Add interviews that are not archived yet, in any order
+    void append(std::vector<Interview> batch) {
+        if (batch.empty()) return;
+        std::sort(batch.begin(), batch.end(), earlier);
+        
+        // Segments are immutable and only this caller appends, so encoding
+        // happens outside the lock
+        bool merge_last = false;
+        std::shared_ptr<const ArchiveSegment> last;
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(mutex);
+            if (!segments.empty()) last = segments.back();
+        }
+        if (last && last->size() < SEGMENT_RECORDS / 2 && last->size() + batch.size() <= SEGMENT_RECORDS) {
+            std::vector<Interview> merged;
+            merged.reserve(last->size() + batch.size());
+            last->for_each([&merged](const Interview& interview) { merged.push_back(interview); });
+            size_t middle = merged.size();
+            merged.insert(merged.end(), batch.begin(), batch.end());
+            std::inplace_merge(merged.begin(), merged.begin() + middle, merged.end(), earlier);
+            batch.swap(merged);
+            merge_last = true;
+        }
+        
+        std::vector<std::shared_ptr<const ArchiveSegment>> built;
+        for (size_t first = 0; first < batch.size(); first += SEGMENT_RECORDS) {
+            size_t last_record = std::min(batch.size(), first + SEGMENT_RECORDS);
+            std::vector<Interview> piece(batch.begin() + first, batch.begin() + last_record);
+            built.push_back(std::make_shared<const ArchiveSegment>(piece));
+        }
+        
+        std::unique_lock<std::shared_timed_mutex> lock(mutex);
+        if (merge_last) {
+            record_count -= segments.back()->size();
+            segments.pop_back();
+        }
+        for (std::shared_ptr<const ArchiveSegment>& segment : built) {
+            record_count += segment->size();
+            segments.push_back(std::move(segment));
+        }
+    }
+    
+    // Add a segment read back from a snapshot
+    void restore(std::shared_ptr<const ArchiveSegment> segment) {
+        std::unique_lock<std::shared_timed_mutex> lock(mutex);
+        record_count += segment->size();
+        segments.push_back(std::move(segment));
+    }
+    
+    bool contains(int interview_id) const {
+        std::shared_lock<std::shared_timed_mutex> lock(mutex);
+        for (const std::shared_ptr<const ArchiveSegment>& segment : segments) {
+            if (interview_id >= segment->min_id() && interview_id <= segment->max_id() &&
+                segment->contains(interview_id)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // Decoded copy of an archived interview, or null
+    std::unique_ptr<Interview> get(int interview_id) const {
+        std::shared_lock<std::shared_timed_mutex> lock(mutex);
+        for (const std::shared_ptr<const ArchiveSegment>& segment : segments) {
+            if (interview_id < segment->min_id() || interview_id > segment->max_id()) continue;
+            if (std::unique_ptr<Interview> interview = segment->get(interview_id)) return interview;
+        }
+        return nullptr;
+    }
+    
+    // Decoded copies of the archived interviews overlapping [start, end),
+    // ordered by start time
+    std::vector<Interview> in_range(const std::chrono::system_clock::time_point& start,
+                                    const std::chrono::system_clock::time_point& end) const {
+        std::vector<Interview> result;
+        std::shared_lock<std::shared_timed_mutex> lock(mutex);
+        for (const std::shared_ptr<const ArchiveSegment>& segment : segments) {
+            size_t middle = result.size();
+            segment->in_range(start, end, result);
+            std::inplace_merge(result.begin(), result.begin() + middle, result.end(), earlier);
+        }
+        return result;
+    }
+};
+
+// Binary snapshot layout, version 6. All fields are in native byte order and
+// every section starts on an 8-byte boundary:
+//
+//   SnapshotHeader
+//   uint64_t string_offsets[string_count + 1]   into the character data
+//   char     string_data[string_bytes]          padded to 8 bytes
+//   SnapshotUser      users[user_count]         in id order
+//   uint32_t slot_starts[slot_count]            availability, minutes since epoch_seconds
+//   uint32_t slot_ends[slot_count]              padded to 8 bytes
+//   SnapshotInterview interviews[interview_count]   in start-time order
+//   SnapshotRuleHeader                          weekly rules; absent in version 1
+//   SnapshotRule      rules[rule_count]
+//   uint32_t window_starts[window_count]        minutes into the week
+//   uint32_t window_ends[window_count]          padded to 8 bytes
+//   int64_t  exceptions[2 * exception_count]    Unix seconds, start then end
+//   SnapshotArchiveHeader                       archive; absent before version 3
+//   per archive segment:
+//     SnapshotSegment
+//     char     segment_bytes[byte_count]        encoded records, padded to 8 bytes; times
+//                                               to the second before version 5
+//     uint64_t string_offsets[string_count + 1]
+//     char     string_data[string_bytes]        padded to 8 bytes
+//   SnapshotExternalHeader                      cross-scheduler state; absent before version 4
+//   SnapshotHold      holds[hold_count]         reserved, not yet resolved
+//   SnapshotExternal  external[external_count]  local side of interviews owned elsewhere
+//
+// Names, emails, candidates, positions and notes are stored once in the
+// string table and referenced by index. Before version 6, interviews, holds
+// and external bookings end before their *_nanoseconds fields and keep
+// times to the second.
+const char SNAPSHOT_MAGIC[4] = {'C', 'F', 'S', 'N'};
+const uint32_t SNAPSHOT_VERSION = 6;
+
+// SnapshotInterview::flags bit: the interviewer is a user of another
+// scheduler of a ShardedScheduler, so only the HR manager is restored
+const uint32_t SNAPSHOT_REMOTE_INTERVIEWER = 1;
+
+// State bits of an external booking in snapshots and log records
+const uint32_t EXTERNAL_ACTIVE = 1;
+const uint32_t EXTERNAL_MOVING = 2;
+const uint32_t EXTERNAL_LISTED = 4;     // among its user's scheduled interviews
+
+struct SnapshotHeader {
+    char magic[4];
+    uint32_t version;
+    int64_t epoch_seconds;      // CompactTime epoch the slot minutes are relative to
+    uint64_t string_count;
+    uint64_t string_bytes;
+    uint64_t user_count;
+    uint64_t slot_count;
+    uint64_t interview_count;
+};
+
+struct SnapshotUser {
+    int32_t id;
+    uint32_t role;
+    uint32_t name;
+    uint32_t email;
+    uint64_t first_slot;
+    uint64_t slot_count;
+};
+
+struct SnapshotInterview {
+    int32_t id;
+    int32_t hr_manager_id;
+    int32_t interviewer_id;
+    uint32_t status;
+    uint32_t candidate_name;
+    uint32_t position;
+    uint32_t notes;
+    uint32_t flags;             // SNAPSHOT_REMOTE_INTERVIEWER; zero before it existed
+    int64_t start_seconds;      // Unix time
+    int64_t end_seconds;
+    uint32_t start_nanoseconds; // past the second
+    uint32_t end_nanoseconds;
+};
+
+struct SnapshotRuleHeader {
+    uint64_t rule_count;
+    uint64_t window_count;
+    uint64_t exception_count;
+};
+
+struct SnapshotArchiveHeader {
+    uint64_t segment_count;
+};
+
+struct SnapshotSegment {
+    uint64_t record_count;
+    uint64_t byte_count;
+    uint64_t string_count;
+    uint64_t string_bytes;
+};
+
+struct SnapshotExternalHeader {
+    uint64_t hold_count;
+    uint64_t external_count;
+};
+
+struct SnapshotHold {
+    int32_t interview_id;
+    int32_t owner;
+    uint32_t owner_side;
+    uint32_t candidate_name;
+    uint32_t position;
+    int32_t hr_manager_id;
+    int32_t interviewer_id;
+    uint32_t reserved;
+    int64_t start_seconds;      // Unix time
+    int64_t end_seconds;
+    uint32_t start_nanoseconds; // past the second
+    uint32_t end_nanoseconds;
+};
+
+struct SnapshotExternal {
+    int32_t interview_id;
+    int32_t user_id;
+    int32_t owner;
+    uint32_t flags;             // EXTERNAL_ACTIVE, EXTERNAL_MOVING, EXTERNAL_LISTED
+    int64_t start_seconds;      // Unix time
+    int64_t end_seconds;
+    int64_t move_start_seconds; // target of an unfinished move
+    int64_t move_end_seconds;
+    uint32_t start_nanoseconds; // past the second
+    uint32_t end_nanoseconds;
+    uint32_t move_start_nanoseconds;
+    uint32_t move_end_nanoseconds;
+};
+
+struct SnapshotRule {
+    int32_t user_id;
+    uint32_t reserved;
+    int64_t anchor_seconds;     // Unix time
+    int64_t until_seconds;
+    uint64_t first_window;
+    uint64_t window_count;
+    uint64_t first_exception;
+    uint64_t exception_count;
+};
+
+// Read-only view of a whole file, memory-mapped where the platform allows it
+class MappedFile {
+private:
+    const char* bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    std::vector<char> buffer;
+#endif
+
+public:
+    explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+        std::ifstream in(path, std::ios::binary);
+        if (!in) throw std::runtime_error("Cannot open " + path);
+        buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        bytes = buffer.data();
+        length = buffer.size();
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open " + path);
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat " + path);
+        }
+        length = static_cast<size_t>(info.st_size);
+        if (length > 0) {
+            void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map " + path);
+            }
+            ::madvise(mapped, length, MADV_SEQUENTIAL);
+            bytes = static_cast<const char*>(mapped);
+        }
+        ::close(fd);
+#endif
+    }
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    ~MappedFile() {
+#ifndef _WIN32
+        if (bytes) ::munmap(const_cast<char*>(bytes), length);
+#endif
+    }
+    
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+};
+
+// Mutations recorded in the write-ahead log
+enum class LogOp : uint8_t {
+    ADD_USER = 1,
+    ADD_AVAILABILITY,
+    CREATE_INTERVIEW,
+    SET_STATUS,
+    SET_NOTES,
+    MOVE_INTERVIEW,
+    ADD_RECURRENCE,
+    ARCHIVE_INTERVIEWS,
+    CREATE_REMOTE_INTERVIEW,    // CREATE_INTERVIEW whose interviewer is in another scheduler
+    RESERVE_HOLD,
+    RESOLVE_HOLD,
+    SET_EXTERNAL_BOOKING,       // whole state of one external booking
+    DROP_EXTERNAL_BOOKINGS,
+    SUBSECOND_TIMES             // first record of a log; times after it carry nanoseconds
+};
+
+// Builds one log record payload: the op followed by fixed-width fields in
+// native byte order. Strings are length-prefixed, times are Unix seconds and
+// the nanoseconds past them.
+class LogEncoder {
+private:
+    std::string bytes;
+    
+    template <typename T>
+    void put(T value) {
+        bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+public:
+    explicit LogEncoder(LogOp op) { put(static_cast<uint8_t>(op)); }
+    
+    LogEncoder& put_u32(uint32_t value) { put(value); return *this; }
+    LogEncoder& put_i32(int32_t value) { put(value); return *this; }
+    
+    LogEncoder& put_time(const std::chrono::system_clock::time_point& time) {
+        uint32_t nanoseconds;
+        put(split_unix_time(time, nanoseconds));
+        put(nanoseconds);
+        return *this;
+    }
+    
+    LogEncoder& put_slot(const TimeSlot& slot) {
+        return put_time(slot.start_time).put_time(slot.end_time);
+    }
+    
+    LogEncoder& put_string(const std::string& value) {
+        put(static_cast<uint32_t>(value.size()));
+        bytes += value;
+        return *this;
+    }
+    
+    const std::string& data() const { return bytes; }
+};
+
+// Reads a payload written by LogEncoder. Any read past the end clears ok().
+// Logs written before SUBSECOND_TIMES existed store whole seconds only.
+class LogDecoder {
+private:
+    const char* next;
+    const char* end;
+    bool subsecond;
+    bool valid = true;
+    
+    template <typename T>
+    T get() {
+        T value = T();
+        if (static_cast<size_t>(end - next) < sizeof(T)) {
+            valid = false;
+            return value;
+        }
+        std::memcpy(&value, next, sizeof(T));
+        next += sizeof(T);
+        return value;
+    }
+
+public:
+    LogDecoder(const char* data, size_t size, bool subsecond = true)
+        : next(data), end(data + size), subsecond(subsecond) {}
+    
+    bool ok() const { return valid; }
+    
+    LogOp get_op() { return static_cast<LogOp>(get<uint8_t>()); }
+    uint32_t get_u32() { return get<uint32_t>(); }
+    int32_t get_i32() { return get<int32_t>(); }
+    
+    std::chrono::system_clock::time_point get_time() {
+        int64_t seconds = get<int64_t>();
+        uint32_t nanoseconds = subsecond ? get<uint32_t>() : 0;
+        if (nanoseconds >= NANOSECONDS_PER_SECOND) valid = false;
+        return join_unix_time(seconds, valid ? nanoseconds : 0);
+    }
+    
+    TimeSlot get_slot() {
+        auto start = get_time();
+        return TimeSlot(start, get_time());
+    }
+    
+    std::string get_string() {
+        uint32_t size = get<uint32_t>();
+        if (!valid || static_cast<size_t>(end - next) < size) {
+            valid = false;
+            return std::string();
+        }
+        std::string value(next, size);
+        next += size;
+        return value;
+    }
+};
+
+// Append-only log with group commit. append() only copies the framed record
+// into the pending buffer and returns its sequence number; a background
+// thread writes everything pending in one write and one fsync, so records
+// arriving during a flush form the next batch. Callers that need durability
+// wait for their sequence number with wait_durable().
+//
+// Each record is framed as [uint32 length][uint32 CRC-32][payload], so replay
+// can stop cleanly at a torn tail left by a crash. Every open and truncate
+// writes a SUBSECOND_TIMES record first, so records after it are read with
+// nanoseconds even when an older build wrote the start of the file.
+class WriteAheadLog {
+private:
+    std::string path;
+    std::FILE* file;
+    
+    std::mutex mutex;
+    std::condition_variable pending_ready;
+    std::condition_variable flushed;
+    std::string pending;
+    uint64_t appended_sequence = 0;
+    uint64_t durable_sequence = 0;
+    bool flushing = false;
+    bool failed = false;
+    bool stopping = false;
+    std::thread flusher;
+    
+    static bool sync_file(std::FILE* target) {
+        if (std::fflush(target) != 0) return false;
+#ifdef _WIN32
+        return _commit(_fileno(target)) == 0;
+#else
+        return ::fsync(fileno(target)) == 0;
+#endif
+    }
+    
+    void flush_loop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            pending_ready.wait(lock, [this]() { return stopping || !pending.empty(); });
+            if (pending.empty()) return;
+            
+            std::string batch;
+            batch.swap(pending);
+            uint64_t batch_sequence = appended_sequence;
+            flushing = true;
+            lock.unlock();
+            
+            bool written = file && std::fwrite(batch.data(), 1, batch.size(), file) == batch.size() &&
+                           sync_file(file);
+            
+            lock.lock();
+            flushing = false;
+            if (written) {
+                durable_sequence = batch_sequence;
+            } else {
+                failed = true;
+            }
+            flushed.notify_all();
+        }
+    }
+
+public:
+    static uint32_t checksum(const char* data, size_t size) {
+        static const std::array<uint32_t, 256> table = []() {
+            std::array<uint32_t, 256> entries;
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t value = i;
+                for (int bit = 0; bit < 8; ++bit) {
+                    value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+                }
+                entries[i] = value;
+            }
+            return entries;
+        }();
+        
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < size; ++i) {
+            crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+    
+    // Record with its [length][CRC-32] header
+    static std::string frame(const LogEncoder& record) {
+        const std::string& payload = record.data();
+        uint32_t header[2] = {static_cast<uint32_t>(payload.size()),
+                              checksum(payload.data(), payload.size())};
+        return std::string(reinterpret_cast<const char*>(header), sizeof(header)) + payload;
+    }
+    
+    // Open a log for appending, creating it if needed
+    explicit WriteAheadLog(const std::string& path) : path(path), file(std::fopen(path.c_str(), "ab")) {
+        if (!file) throw std::runtime_error("Cannot open log " + path);
+        pending = frame(LogEncoder(LogOp::SUBSECOND_TIMES));
+        flusher = std::thread(&WriteAheadLog::flush_loop, this);
+    }
+    
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+    
+    // Flush whatever is still pending, then close
+    ~WriteAheadLog() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        pending_ready.notify_one();
+        flusher.join();
+        if (file) std::fclose(file);
+    }
+    
+    // Queue a record and return its sequence number without waiting for disk
+    uint64_t append(const LogEncoder& record) {
+        std::string framed = frame(record);
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        pending += framed;
+        uint64_t sequence = ++appended_sequence;
+        pending_ready.notify_one();
+        return sequence;
+    }
+    
+    // Block until a record is on disk. Returns false if a write has failed.
+    bool wait_durable(uint64_t sequence) {
+        std::unique_lock<std::mutex> lock(mutex);
+        flushed.wait(lock, [&]() { return failed || durable_sequence >= sequence; });
+        return !failed;
+    }
+    
+    // Block until everything appended so far is on disk
+    bool sync() {
+        uint64_t sequence;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            sequence = appended_sequence;
+        }
+        return wait_durable(sequence);
+    }
+    
+    // Discard the log contents once they are covered by a snapshot. The caller
+    // must keep new records from being appended until this returns.
+    bool truncate() {
+        if (!sync()) return false;
+        
+        std::unique_lock<std::mutex> lock(mutex);
+        flushed.wait(lock, [this]() { return !flushing; });
+        std::FILE* reopened = std::freopen(path.c_str(), "wb", file);
+        if (!reopened) {
+            file = nullptr;
+            failed = true;
+            return false;
+        }
+        file = reopened;
+        std::string marker = frame(LogEncoder(LogOp::SUBSECOND_TIMES));
+        return std::fwrite(marker.data(), 1, marker.size(), file) == marker.size() && sync_file(file);
+    }
+    
+    const std::string& get_path() const { return path; }
+};
+
+// Deferred reclamation for interviews that left the scheduler's tables while
+// readers may still hold pointers to them. Readers take a Guard; retire()
+// stamps objects with the current epoch, and collect() hands back the ones
+// stamped before both the oldest live guard and the previous collect() call,
+// so an unguarded pointer also survives one full collect period.
+class RetireList {
+private:
+    std::mutex mutex;
+    uint64_t epoch = 1;
+    uint64_t previous_collect = 0;
+    std::map<uint64_t, size_t> guards;      // entry epoch -> live guards
+    std::unordered_map<Interview*, uint64_t> stamps;
+    
+    void leave(uint64_t entered) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = guards.find(entered);
+        if (--it->second == 0) guards.erase(it);
+    }
+
+public:
+    // Keeps every object retired after it was taken alive until destroyed
+    class Guard {
+    private:
+        RetireList* list = nullptr;
+        uint64_t entered = 0;
+        
+        friend class RetireList;
+        Guard(RetireList* list, uint64_t entered) : list(list), entered(entered) {}
+    
+    public:
+        Guard() {}
+        Guard(Guard&& other) : list(other.list), entered(other.entered) { other.list = nullptr; }
+        Guard& operator=(Guard&& other) {
+            if (this != &other) {
+                if (list) list->leave(entered);
+                list = other.list;
+                entered = other.entered;
+                other.list = nullptr;
+            }
+            return *this;
+        }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        ~Guard() {
+            if (list) list->leave(entered);
+        }
+    };
+    
+    Guard enter() {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++guards[epoch];
+        return Guard(this, epoch);
+    }
+    
+    void retire(const std::vector<Interview*>& objects) {
+        if (objects.empty()) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Interview* object : objects) {
+            stamps[object] = epoch;
+        }
+        ++epoch;
+    }
+    
+    // Restamp a retired object that was handed out again
+    void renew(Interview* object) {
+        std::lock_guard<std::mutex> lock(mutex);
+        stamps[object] = epoch++;
+    }
+    
+    // Objects no reader can reach any more; the caller destroys them
+    std::vector<Interview*> collect() {
+        std::lock_guard<std::mutex> lock(mutex);
+        uint64_t limit = guards.empty() ? previous_collect : std::min(previous_collect, guards.begin()->first);
+        previous_collect = epoch++;
+        std::vector<Interview*> reclaimed;
+        for (auto it = stamps.begin(); it != stamps.end();) {
+            if (it->second < limit) {
+                reclaimed.push_back(it->first);
+                it = stamps.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return reclaimed;
+    }
+    
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stamps.size();
+    }
+};
+
+// Scheduler class - main application logic
+//
+// Thread safety: the object pools and id tables are guarded by registry_mutex,
+// and each user's availability, bookings and interview statuses by one of
+// LOCK_SHARDS striped locks keyed on user id. Locks are always taken shards
+// first, in ascending shard order, then the registry. Objects returned by
+// get_user/get_interview must only be mutated directly while no other thread
+// uses the scheduler; concurrent callers go through the Scheduler methods.
+// Interview pointers stay valid while a read_guard() taken before the lookup
+// is held, and without one until the second archive_interviews call after
+// the lookup.
+class Scheduler {
+private:
+    typedef std::shared_timed_mutex SharedMutex;
+    typedef std::unique_lock<SharedMutex> WriteLock;
+    typedef std::shared_lock<SharedMutex> ReadLock;
+    
+    static const size_t LOCK_SHARDS = 64;
+    
+    // Objects live in slab pools; the dense tables index them by id
+    SlabPool<User> user_pool;
+    SlabPool<Interview> interview_pool;
+    DenseIdTable<User> users;
+    DenseIdTable<Interview> interviews;
+    
+    // Users of each role in id order, indexed by UserRole
+    std::vector<User*> role_index[2];
+    
+    // All interviews ordered by start time, per status
+    TimeRangeIndex time_index;
+    
+    // Packed hot fields of every interview
+    InterviewHotTable hot_table;
+    
+    // Versions for snapshot(); maintained once the first view is taken
+    InterviewVersionTable versions;
+    
+    // Finished interviews moved out of the tables above by archive_interviews
+    InterviewArchive archive;
+    
+    // Archived Interview objects, and decoded copies handed out by the
+    // queries' archive fallback (by id), until no reader can hold them.
+    // archived_copies is guarded by registry_mutex.
+    RetireList retired;
+    std::unordered_map<int, Interview*> archived_copies;
+    
+    mutable SharedMutex registry_mutex;
+    mutable std::array<SharedMutex, LOCK_SHARDS> user_locks;
+    
+    // Statistics maintained on every mutation, indexed by UserRole and InterviewStatus
+    std::atomic<size_t> role_counts[2] = {};
+    std::atomic<size_t> status_counts[4] = {};
+    
+    // Optional durability log; records are appended under the locks that
+    // order the mutation, so the log replays in a consistent order
+    WriteAheadLog* wal = nullptr;
+    
+    // Local side of bookings with a user in another scheduler, by interview
+    // id. Guarded by registry_mutex; the user's booking is changed under its
+    // shard lock. Both maps go into snapshots and the log, so a restarted
+    // scheduler keeps the time booked.
+    struct ExternalBooking {
+        int user_id;
+        int owner;
+        TimeSlot slot;
+        bool active;
+        bool moving;            // held at the union of slot and move_to
+        TimeSlot move_to;
+    };
+    std::unordered_map<int, BookingHold> pending_holds;
+    std::unordered_map<int, ExternalBooking> external_bookings;
+    
+    void log_mutation(const LogEncoder& record) {
+        if (wal) wal->append(record);
+    }
+    
+    // Publish an interview's new state to the version table. Callers hold a
+    // shard lock of the interview's users, which orders this with snapshot().
+    void publish(const Interview* interview) {
+        if (versions.enabled()) versions.update(interview);
+    }
+    
+    void count_status_change(InterviewStatus from, InterviewStatus to) {
+        if (from == to) return;
+        status_counts[static_cast<size_t>(from)].fetch_sub(1, std::memory_order_relaxed);
+        status_counts[static_cast<size_t>(to)].fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    // Change a status and its counters. Caller holds both users' shard locks.
+    void set_status_locked(Interview* interview, InterviewStatus new_status) {
+        if (interview->get_status() == new_status) return;
+        count_status_change(interview->get_status(), new_status);
+        time_index.erase(interview);
+        interview->set_status(new_status);
+        time_index.insert(interview);
+        hot_table.set_status(interview->get_id(), new_status);
+        publish(interview);
+        log_mutation(LogEncoder(LogOp::SET_STATUS).put_i32(interview->get_id())
+                         .put_u32(static_cast<uint32_t>(new_status)));
+    }
+    
+    static size_t shard_of(int user_id) {
+        return static_cast<size_t>(user_id) % LOCK_SHARDS;
+    }
+    
+    // Shard locks for the two users of a booking
+    template <typename Lock>
+    struct PairLock {
+        Lock first;
+        Lock second;
+    };
+    
+    template <typename Lock>
+    PairLock<Lock> lock_pair(int user_a, int user_b) const {
+        size_t a = shard_of(user_a), b = shard_of(user_b);
+        if (a > b) std::swap(a, b);
+        
+        PairLock<Lock> guard;
+        guard.first = Lock(user_locks[a]);
+        if (b != a) guard.second = Lock(user_locks[b]);
+        return guard;
+    }
+    
+    // Lock a set of shards in ascending order
+    template <typename Lock>
+    std::vector<Lock> lock_shards(std::vector<size_t> shards) const {
+        std::sort(shards.begin(), shards.end());
+        shards.erase(std::unique(shards.begin(), shards.end()), shards.end());
+        
+        std::vector<Lock> locks;
+        locks.reserve(shards.size());
+        for (size_t shard : shards) {
+            locks.emplace_back(user_locks[shard]);
+        }
+        return locks;
+    }
+    
+    template <typename Lock>
+    std::vector<Lock> lock_all_shards() const {
+        std::vector<size_t> shards(LOCK_SHARDS);
+        for (size_t i = 0; i < LOCK_SHARDS; ++i) shards[i] = i;
+        return lock_shards<Lock>(shards);
+    }
+    
+    // Lock the shards of an interview's users, then find the interview and
+    // its users. The lookup is repeated under the shard locks because
+    // archive_interviews may free the interview before they are taken.
+    // Returns false, holding no locks, if the interview is not live.
+    bool lock_interview(int interview_id, PairLock<WriteLock>& guard, Interview*& interview,
+                        User*& hr_manager, User*& interviewer) {
+        int hr_manager_id, interviewer_id;
+        {
+            ReadLock registry(registry_mutex);
+            Interview* found = interviews.get(interview_id);
+            if (!found) return false;
+            hr_manager_id = found->get_hr_manager_id();
+            interviewer_id = found->get_interviewer_id();
+        }
+        
+        guard = lock_pair<WriteLock>(hr_manager_id, interviewer_id);
+        ReadLock registry(registry_mutex);
+        interview = interviews.get(interview_id);
+        if (!interview) {
+            guard = PairLock<WriteLock>();
+            return false;
+        }
+        hr_manager = users.get(hr_manager_id);
+        interviewer = users.get(interviewer_id);
+        return true;
+    }
+    
+    // Allocate an interview and index it by id. Caller holds registry_mutex.
+    Interview* create_interview(int interview_id, const std::string& candidate_name,
+                                const std::string& position, int hr_manager_id,
+                                int interviewer_id, const TimeSlot& time_slot) {
+        Interview* interview = interview_pool.get(
+            interview_pool.create(interview_id, candidate_name, position, hr_manager_id,
+                                  interviewer_id, time_slot));
+        interviews.insert(interview->get_id(), interview);
+        status_counts[static_cast<size_t>(InterviewStatus::SCHEDULED)].fetch_add(
+            1, std::memory_order_relaxed);
+        time_index.insert(interview);
+        hot_table.update(interview);
+        publish(interview);
+        LogOp op = users.get(interviewer_id) ? LogOp::CREATE_INTERVIEW : LogOp::CREATE_REMOTE_INTERVIEW;
+        log_mutation(LogEncoder(op).put_i32(interview_id).put_string(candidate_name)
+                         .put_string(position).put_i32(hr_manager_id)
+                         .put_i32(interviewer_id).put_slot(time_slot));
+        return interview;
+    }
+    
+    // Register a new interview with both users; a null interviewer lives in
+    // another scheduler. Caller holds both shard locks.
+    static void attach_interview(Interview* interview, User* hr_manager, User* interviewer) {
+        int interview_id = interview->get_id();
+        
+        // Add to users' scheduled interviews
+        hr_manager->add_scheduled_interview(interview_id);
+        hr_manager->add_active_booking(interview_id, interview->get_time_slot());
+        if (interviewer) {
+            interviewer->add_scheduled_interview(interview_id);
+            interviewer->add_active_booking(interview_id, interview->get_time_slot());
+        }
+    }
+    
+    // Create an already validated interview and register it with both users.
+    // Caller holds both shard locks.
+    int commit_interview(const std::string& candidate_name, const std::string& position,
+                         User* hr_manager, User* interviewer, const TimeSlot& time_slot) {
+        Interview* interview;
+        {
+            WriteLock registry(registry_mutex);
+            interview = create_interview(Interview::id_generator().next(), candidate_name, position,
+                                         hr_manager->get_id(), interviewer->get_id(), time_slot);
+        }
+        attach_interview(interview, hr_manager, interviewer);
+        return interview->get_id();
+    }
+    
+    // Move an active interview's bookings to a new slot without checks or a
+    // status change. Caller holds both users' shard locks.
+    void move_locked(Interview* interview, User* hr_manager, User* interviewer, const TimeSlot& new_slot) {
+        int interview_id = interview->get_id();
+        hr_manager->remove_active_booking(interview_id, interview->get_time_slot());
+        if (interviewer) interviewer->remove_active_booking(interview_id, interview->get_time_slot());
+        
+        time_index.erase(interview);
+        interview->set_time_slot(new_slot);
+        time_index.insert(interview);
+        hot_table.set_slot(interview_id, CompactTime::to_compact(new_slot));
+        publish(interview);
+        
+        hr_manager->add_active_booking(interview_id, new_slot);
+        if (interviewer) interviewer->add_active_booking(interview_id, new_slot);
+        log_mutation(LogEncoder(LogOp::MOVE_INTERVIEW).put_i32(interview_id).put_slot(new_slot));
+    }
+    
+    // Cancel an interview. Caller holds both users' shard locks.
+    void cancel_locked(Interview* interview, User* hr_manager, User* interviewer) {
+        int interview_id = interview->get_id();
+        
+        // Remove from users' scheduled interviews
+        if (interview->is_active()) {
+            if (hr_manager) hr_manager->remove_active_booking(interview_id, interview->get_time_slot());
+            if (interviewer) interviewer->remove_active_booking(interview_id, interview->get_time_slot());
+        }
+        
+        set_status_locked(interview, InterviewStatus::CANCELLED);
+        
+        if (hr_manager) hr_manager->remove_scheduled_interview(interview_id);
+        if (interviewer) interviewer->remove_scheduled_interview(interview_id);
+    }
+    
+    // Run all booking checks for a pair of users, cheapest first
+    static ScheduleError validate_booking(const User* hr_manager, const User* interviewer,
+                                          const TimeSlot& slot) {
+        if (!hr_manager || !interviewer) return ScheduleError::INVALID_USER;
+        if (hr_manager->get_role() != UserRole::HR_MANAGER) return ScheduleError::NOT_HR_MANAGER;
+        if (interviewer->get_role() != UserRole::INTERVIEWER) return ScheduleError::NOT_INTERVIEWER;
+        if (!CompactTime::in_range(slot)) return ScheduleError::OUT_OF_RANGE;
+        CompactSlot time_slot = CompactTime::to_compact(slot);
+        if (!hr_manager->is_available(time_slot)) return ScheduleError::HR_MANAGER_UNAVAILABLE;
+        if (!interviewer->is_available(time_slot)) return ScheduleError::INTERVIEWER_UNAVAILABLE;
+        if (hr_manager->has_booking_conflict(time_slot) ||
+            interviewer->has_booking_conflict(time_slot)) {
+            return ScheduleError::TIME_CONFLICT;
+        }
+        return ScheduleError::NONE;
+    }
+    
+    // Checks for moving an interview; its own booking is not a conflict. An
+    // interviewer missing here lives in another scheduler of a
+    // ShardedScheduler, which checks that side through its external booking.
+    static ScheduleError validate_move(const Interview* interview, const User* hr_manager,
+                                       const User* interviewer, const TimeSlot& slot) {
+        if (!interview->is_active()) return ScheduleError::INVALID_INTERVIEW;
+        if (!hr_manager) return ScheduleError::INVALID_USER;
+        if (!CompactTime::in_range(slot)) return ScheduleError::OUT_OF_RANGE;
+        if (!hr_manager->is_available(slot)) return ScheduleError::HR_MANAGER_UNAVAILABLE;
+        if (interviewer && !interviewer->is_available(slot)) return ScheduleError::INTERVIEWER_UNAVAILABLE;
+        if (hr_manager->has_booking_conflict(slot, interview->get_id()) ||
+            (interviewer && interviewer->has_booking_conflict(slot, interview->get_id()))) {
+            return ScheduleError::TIME_CONFLICT;
+        }
+        return ScheduleError::NONE;
+    }
+    
+    // Checks for one side of a cross-scheduler booking
+    static ScheduleError validate_hold(const User* user, bool hr_side, const TimeSlot& slot) {
+        if (!user) return ScheduleError::INVALID_USER;
+        if (hr_side && user->get_role() != UserRole::HR_MANAGER) return ScheduleError::NOT_HR_MANAGER;
+        if (!hr_side && user->get_role() != UserRole::INTERVIEWER) return ScheduleError::NOT_INTERVIEWER;
+        if (!CompactTime::in_range(slot)) return ScheduleError::OUT_OF_RANGE;
+        CompactSlot time_slot = CompactTime::to_compact(slot);
+        if (!user->is_available(time_slot)) {
+            return hr_side ? ScheduleError::HR_MANAGER_UNAVAILABLE : ScheduleError::INTERVIEWER_UNAVAILABLE;
+        }
+        if (user->has_booking_conflict(time_slot)) return ScheduleError::TIME_CONFLICT;
+        return ScheduleError::NONE;
+    }
+    
+    static int local_user_of(const BookingHold& hold) {
+        return hold.owner_side ? hold.request.hr_manager_id : hold.request.interviewer_id;
+    }
+    
+    // Run fn(booking, user) on an external booking under its user's shard
+    // lock and the registry. Returns false if there is no such booking.
+    template <typename Fn>
+    bool with_external_booking(int interview_id, Fn fn) {
+        int user_id;
+        {
+            ReadLock registry(registry_mutex);
+            auto it = external_bookings.find(interview_id);
+            if (it == external_bookings.end()) return false;
+            user_id = it->second.user_id;
+        }
+        WriteLock shard(user_locks[shard_of(user_id)]);
+        WriteLock registry(registry_mutex);
+        auto it = external_bookings.find(interview_id);
+        User* user = users.get(user_id);
+        if (it == external_bookings.end() || !user) return false;
+        fn(it->second, user);
+        return true;
+    }
+    
+    // Slots an external booking holds in its user's conflict index. A move
+    // in progress holds both slots, or their union where they overlap.
+    static std::vector<TimeSlot> held_slots(const ExternalBooking& booking) {
+        std::vector<TimeSlot> slots;
+        if (!booking.active) return slots;
+        const TimeSlot& old_slot = booking.slot;
+        const TimeSlot& new_slot = booking.move_to;
+        if (!booking.moving) {
+            slots.push_back(old_slot);
+        } else if (old_slot.start_time <= new_slot.end_time && new_slot.start_time <= old_slot.end_time) {
+            slots.push_back(TimeSlot(std::min(old_slot.start_time, new_slot.start_time),
+                                     std::max(old_slot.end_time, new_slot.end_time)));
+        } else {
+            slots.push_back(old_slot);
+            slots.push_back(new_slot);
+        }
+        return slots;
+    }
+    
+    static uint32_t external_flags(int interview_id, const ExternalBooking& booking, const User* user) {
+        return (booking.active ? EXTERNAL_ACTIVE : 0) | (booking.moving ? EXTERNAL_MOVING : 0) |
+               (user->get_scheduled_interviews().count(interview_id) ? EXTERNAL_LISTED : 0);
+    }
+    
+    // Log the whole state of an external booking after a change. Caller holds
+    // its user's shard lock and the registry.
+    void log_external_booking(int interview_id, const ExternalBooking& booking, const User* user) {
+        log_mutation(LogEncoder(LogOp::SET_EXTERNAL_BOOKING).put_i32(interview_id).put_i32(booking.user_id)
+                         .put_i32(booking.owner).put_u32(external_flags(interview_id, booking, user))
+                         .put_slot(booking.slot).put_slot(booking.move_to));
+    }
+    
+    // Whether an interview id is taken here by an interview, a hold or an
+    // external booking. Caller holds the registry.
+    bool knows_interview_locked(int interview_id) const {
+        return interviews.get(interview_id) || archive.contains(interview_id) ||
+               pending_holds.count(interview_id) || external_bookings.count(interview_id);
+    }
+    
+    // Set an external booking to a logged or saved state, replacing its old
+    // one. Caller holds the user's shard lock and the registry.
+    void install_external_booking_locked(int interview_id, const ExternalBooking& booking, uint32_t flags,
+                                         User* user) {
+        auto it = external_bookings.find(interview_id);
+        if (it != external_bookings.end()) {
+            for (const TimeSlot& slot : held_slots(it->second)) {
+                user->remove_active_booking(interview_id, slot);
+            }
+            external_bookings.erase(it);
+        }
+        for (const TimeSlot& slot : held_slots(booking)) {
+            user->add_active_booking(interview_id, slot);
+        }
+        if (flags & EXTERNAL_LISTED) {
+            user->add_scheduled_interview(interview_id);
+        } else {
+            user->remove_scheduled_interview(interview_id);
+        }
+        external_bookings.emplace(interview_id, booking);
+    }
+    
+    // Move finished interviews from the live tables into the archive and log
+    // their ids. Caller holds every shard lock and the registry exclusively.
+    size_t archive_locked(const std::vector<Interview*>& batch) {
+        if (batch.empty()) return 0;
+        std::vector<Interview> copies;
+        copies.reserve(batch.size());
+        LogEncoder record(LogOp::ARCHIVE_INTERVIEWS);
+        record.put_u32(static_cast<uint32_t>(batch.size()));
+        for (Interview* interview : batch) {
+            int interview_id = interview->get_id();
+            copies.push_back(*interview);
+            record.put_i32(interview_id);
+            if (User* hr_manager = users.get(interview->get_hr_manager_id())) {
+                hr_manager->remove_scheduled_interview(interview_id);
+            }
+            if (User* interviewer = users.get(interview->get_interviewer_id())) {
+                interviewer->remove_scheduled_interview(interview_id);
+            }
+            time_index.erase(interview);
+            hot_table.erase(interview_id);
+            if (versions.enabled()) versions.erase(interview_id);
+            interviews.erase(interview_id);
+        }
+        archive.append(std::move(copies));
+        retired.retire(batch);
+        log_mutation(record);
+        return batch.size();
+    }
+    
+    // Destroy the retired interviews no reader can reach any more. Caller
+    // holds the registry exclusively.
+    void reclaim_retired_locked() {
+        for (Interview* interview : retired.collect()) {
+            auto it = archived_copies.find(interview->get_id());
+            if (it != archived_copies.end() && it->second == interview) archived_copies.erase(it);
+            interview_pool.destroy(interview_pool.handle_of(interview));
+        }
+    }
+    
+    // Interview object for an archived interview. Each is decoded once, kept
+    // in archived_copies and retired straight away, so it is reclaimed like
+    // an archived live object once readers are done with it. Caller holds
+    // the registry exclusively.
+    Interview* archived_copy_locked(const Interview& decoded) {
+        auto it = archived_copies.find(decoded.get_id());
+        if (it != archived_copies.end()) {
+            retired.renew(it->second);
+            return it->second;
+        }
+        Interview* copy = interview_pool.get(interview_pool.create(decoded));
+        archived_copies.emplace(decoded.get_id(), copy);
+        retired.retire(std::vector<Interview*>(1, copy));
+        return copy;
+    }
+    
+    // Live interviews of a range query merged with the archived ones, by
+    // start time
+    std::vector<Interview*> with_archived(std::vector<Interview*> live, std::vector<Interview> archived) {
+        if (archived.empty()) return live;
+        {
+            WriteLock registry(registry_mutex);
+            for (const Interview& interview : archived) {
+                live.push_back(archived_copy_locked(interview));
+            }
+        }
+        std::stable_sort(live.begin(), live.end(), [](const Interview* a, const Interview* b) {
+            return a->get_time_slot().start_time < b->get_time_slot().start_time;
+        });
+        return live;
+    }
+    
+    // Forget the local side of finished cross-scheduler bookings that ended by
+    // horizon; their owner archives the interview with the same horizon.
+    // Caller holds every shard lock and the registry exclusively.
+    void drop_finished_external_bookings(const std::chrono::system_clock::time_point& horizon) {
+        std::vector<int> dropped;
+        for (const auto& entry : external_bookings) {
+            const ExternalBooking& booking = entry.second;
+            if (!booking.active && !booking.moving && booking.slot.end_time <= horizon) {
+                dropped.push_back(entry.first);
+            }
+        }
+        drop_external_bookings_locked(dropped);
+    }
+    
+    // Forget inactive external bookings and log their ids. Caller holds every
+    // shard lock and the registry exclusively.
+    void drop_external_bookings_locked(const std::vector<int>& interview_ids) {
+        if (interview_ids.empty()) return;
+        LogEncoder record(LogOp::DROP_EXTERNAL_BOOKINGS);
+        record.put_u32(static_cast<uint32_t>(interview_ids.size()));
+        for (int interview_id : interview_ids) {
+            auto it = external_bookings.find(interview_id);
+            record.put_i32(interview_id);
+            if (it == external_bookings.end() || it->second.active) continue;
+            if (User* user = users.get(it->second.user_id)) user->remove_scheduled_interview(interview_id);
+            external_bookings.erase(it);
+        }
+        log_mutation(record);
+    }
+    
+    // Replay a logged archive run: archive those of the ids that are still live
+    void restore_archive(const std::vector<int>& interview_ids) {
+        auto shard_guard = lock_all_shards<WriteLock>();
+        WriteLock registry(registry_mutex);
+        std::vector<Interview*> batch;
+        for (int interview_id : interview_ids) {
+            Interview* interview = interviews.get(interview_id);
+            if (interview && !interview->is_active()) batch.push_back(interview);
+        }
+        archive_locked(batch);
+    }
+    
+    // Recreate a logged interview under its original id, skipping ids that
+    // already exist or are archived because the snapshot covers them. A
+    // remote interviewer is kept by id only. Throws if a local participant
+    // is missing, since the log would otherwise lose the interview.
+    void restore_interview(int interview_id, const std::string& candidate_name, const std::string& position,
+                           int hr_manager_id, int interviewer_id, const TimeSlot& time_slot,
+                           bool remote_interviewer) {
+        User* hr_manager = get_user(hr_manager_id);
+        User* interviewer = remote_interviewer ? nullptr : get_user(interviewer_id);
+        if (!hr_manager || (!remote_interviewer && !interviewer) || interview_id <= 0) {
+            throw std::runtime_error("Log record of interview " + std::to_string(interview_id) +
+                                     " refers to a missing user");
+        }
+        
+        auto shard_guard = lock_pair<WriteLock>(hr_manager_id, interviewer_id);
+        Interview* interview;
+        {
+            WriteLock registry(registry_mutex);
+            if (interviews.get(interview_id) || archive.contains(interview_id)) return;
+            Interview::id_generator().advance_past(interview_id);
+            interview = create_interview(interview_id, candidate_name, position, hr_manager_id,
+                                         interviewer_id, time_slot);
+        }
+        attach_interview(interview, hr_manager, interviewer);
+    }
+    
+    // Replay a logged move of an active interview
+    void restore_move(int interview_id, const TimeSlot& new_slot) {
+        Interview* interview;
+        User* hr_manager;
+        User* interviewer;
+        PairLock<WriteLock> shard_guard;
+        if (!lock_interview(interview_id, shard_guard, interview, hr_manager, interviewer)) return;
+        if (interview->is_active() && hr_manager) {
+            move_locked(interview, hr_manager, interviewer, new_slot);
+        }
+    }
+    
+    // Replay a logged hold unless its interview id is already known here
+    void restore_hold(const BookingHold& hold) {
+        int user_id = local_user_of(hold);
+        WriteLock shard(user_locks[shard_of(user_id)]);
+        WriteLock registry(registry_mutex);
+        User* user = users.get(user_id);
+        if (!user || hold.interview_id <= 0) {
+            throw std::runtime_error("Log record of hold " + std::to_string(hold.interview_id) +
+                                     " refers to a missing user");
+        }
+        if (knows_interview_locked(hold.interview_id)) return;
+        Interview::id_generator().advance_past(hold.interview_id);
+        user->add_active_booking(hold.interview_id, hold.request.time_slot);
+        pending_holds.emplace(hold.interview_id, hold);
+    }
+    
+    // Replay the logged state of an external booking
+    void restore_external_booking(int interview_id, const ExternalBooking& booking, uint32_t flags) {
+        WriteLock shard(user_locks[shard_of(booking.user_id)]);
+        WriteLock registry(registry_mutex);
+        User* user = users.get(booking.user_id);
+        if (!user || interview_id <= 0) {
+            throw std::runtime_error("Log record of external booking " + std::to_string(interview_id) +
+                                     " refers to a missing user");
+        }
+        Interview::id_generator().advance_past(interview_id);
+        install_external_booking_locked(interview_id, booking, flags, user);
+    }
+    
+    // Apply one decoded log record. Returns false if the payload is malformed.
+    bool apply_log_record(LogDecoder& record) {
+        LogOp op = record.get_op();
+        switch (op) {
+            case LogOp::ADD_USER: {
+                int user_id = record.get_i32();
+                std::string name = record.get_string();
+                std::string email = record.get_string();
+                uint32_t role = record.get_u32();
+                if (!record.ok() || role > static_cast<uint32_t>(UserRole::INTERVIEWER)) return false;
+                add_user_with_id(user_id, name, email, static_cast<UserRole>(role));
+                return true;
+            }
+            case LogOp::ADD_AVAILABILITY: {
+                int user_id = record.get_i32();
+                uint32_t count = record.get_u32();
+                std::vector<TimeSlot> slots;
+                for (uint32_t i = 0; i < count && record.ok(); ++i) {
+                    slots.push_back(record.get_slot());
+                }
+                if (!record.ok()) return false;
+                add_availability(user_id, slots);
+                return true;
+            }
+            case LogOp::ARCHIVE_INTERVIEWS: {
+                uint32_t count = record.get_u32();
+                std::vector<int> interview_ids;
+                for (uint32_t i = 0; i < count && record.ok(); ++i) {
+                    interview_ids.push_back(record.get_i32());
+                }
+                if (!record.ok()) return false;
+                restore_archive(interview_ids);
+                return true;
+            }
+            case LogOp::ADD_RECURRENCE: {
+                int user_id = record.get_i32();
+                TimeSlot span = record.get_slot();
+                RecurringAvailability rule(span.start_time, span.end_time);
+                uint32_t window_count = record.get_u32();
+                for (uint32_t i = 0; i < window_count && record.ok(); ++i) {
+                    uint32_t start = record.get_u32();
+                    uint32_t end = record.get_u32();
+                    if (end > RecurringAvailability::WEEK_MINUTES || start >= end) return false;
+                    rule.add_window(0, static_cast<int>(start), static_cast<int>(end));
+                }
+                uint32_t exception_count = record.get_u32();
+                for (uint32_t i = 0; i < exception_count && record.ok(); ++i) {
+                    rule.add_exception(record.get_slot());
+                }
+                if (!record.ok()) return false;
+                add_recurring_availability(user_id, rule);
+                return true;
+            }
+            case LogOp::CREATE_INTERVIEW:
+            case LogOp::CREATE_REMOTE_INTERVIEW: {
+                int interview_id = record.get_i32();
+                std::string candidate_name = record.get_string();
+                std::string position = record.get_string();
+                int hr_manager_id = record.get_i32();
+                int interviewer_id = record.get_i32();
+                TimeSlot time_slot = record.get_slot();
+                if (!record.ok()) return false;
+                restore_interview(interview_id, candidate_name, position, hr_manager_id, interviewer_id,
+                                  time_slot, op == LogOp::CREATE_REMOTE_INTERVIEW);
+                return true;
+            }
+            case LogOp::SET_STATUS: {
+                int interview_id = record.get_i32();
+                uint32_t status = record.get_u32();
+                if (!record.ok() || status > static_cast<uint32_t>(InterviewStatus::RESCHEDULED)) return false;
+                update_interview_status(interview_id, static_cast<InterviewStatus>(status));
+                return true;
+            }
+            case LogOp::SET_NOTES: {
+                int interview_id = record.get_i32();
+                std::string notes = record.get_string();
+                if (!record.ok()) return false;
+                set_interview_notes(interview_id, notes);
+                return true;
+            }
+            case LogOp::MOVE_INTERVIEW: {
+                int interview_id = record.get_i32();
+                TimeSlot new_slot = record.get_slot();
+                if (!record.ok()) return false;
+                restore_move(interview_id, new_slot);
+                return true;
+            }
+            case LogOp::RESERVE_HOLD: {
+                int interview_id = record.get_i32();
+                uint32_t owner_side = record.get_u32();
+                int owner = record.get_i32();
+                std::string candidate_name = record.get_string();
+                std::string position = record.get_string();
+                int hr_manager_id = record.get_i32();
+                int interviewer_id = record.get_i32();
+                TimeSlot time_slot = record.get_slot();
+                if (!record.ok() || owner_side > 1) return false;
+                restore_hold(BookingHold{interview_id,
+                                         ScheduleRequest{candidate_name, position, hr_manager_id, interviewer_id,
+                                                         time_slot},
+                                         owner_side != 0, owner});
+                return true;
+            }
+            case LogOp::RESOLVE_HOLD: {
+                int interview_id = record.get_i32();
+                uint32_t commit = record.get_u32();
+                if (!record.ok() || commit > 1) return false;
+                resolve_holds(std::vector<HoldDecision>(1, HoldDecision{interview_id, commit != 0}));
+                return true;
+            }
+            case LogOp::SET_EXTERNAL_BOOKING: {
+                int interview_id = record.get_i32();
+                int user_id = record.get_i32();
+                int owner = record.get_i32();
+                uint32_t flags = record.get_u32();
+                TimeSlot slot = record.get_slot();
+                TimeSlot move_to = record.get_slot();
+                if (!record.ok() || flags > (EXTERNAL_ACTIVE | EXTERNAL_MOVING | EXTERNAL_LISTED) ||
+                    (flags & (EXTERNAL_ACTIVE | EXTERNAL_MOVING)) == EXTERNAL_MOVING) {
+                    return false;
+                }
+                restore_external_booking(interview_id,
+                                         ExternalBooking{user_id, owner, slot, (flags & EXTERNAL_ACTIVE) != 0,
+                                                         (flags & EXTERNAL_MOVING) != 0, move_to},
+                                         flags);
+                return true;
+            }
+            case LogOp::DROP_EXTERNAL_BOOKINGS: {
+                uint32_t count = record.get_u32();
+                std::vector<int> interview_ids;
+                for (uint32_t i = 0; i < count && record.ok(); ++i) {
+                    interview_ids.push_back(record.get_i32());
+                }
+                if (!record.ok()) return false;
+                auto shard_guard = lock_all_shards<WriteLock>();
+                WriteLock registry(registry_mutex);
+                drop_external_bookings_locked(interview_ids);
+                return true;
+            }
+            case LogOp::SUBSECOND_TIMES:
+                return true;
+            default:
+                return false;
+        }
+    }
+    
+public:
+    // Add user to system
+    int add_user(const std::string& name, const std::string& email, UserRole role) {
+        return add_user_with_id(User::id_generator().next(), name, email, role);
+    }
+    
+    // Add user under an id reserved from User::id_generator(), e.g. by a bulk
+    // loader that owns an IdBlock. Returns 0 if the id is invalid or taken.
+    int add_user_with_id(int user_id, const std::string& name, const std::string& email,
+                         UserRole role) {
+        CLOUDFIT_TIME_OP(ADD_USER, user_id, 0);
+        WriteLock registry(registry_mutex);
+        if (user_id <= 0 || users.get(user_id)) return 0;
+        User::id_generator().advance_past(user_id);
+        
+        User* user = user_pool.get(user_pool.create(user_id, name, email, role));
+        users.insert(user_id, user);
+        
+        // Ids are normally increasing, so this is almost always an append
+        std::vector<User*>& by_role = role_index[static_cast<size_t>(role)];
+        auto pos = std::upper_bound(by_role.begin(), by_role.end(), user_id,
+                                    [](int id, const User* other) { return id < other->get_id(); });
+        by_role.insert(pos, user);
+        role_counts[static_cast<size_t>(role)].fetch_add(1, std::memory_order_relaxed);
+        log_mutation(LogEncoder(LogOp::ADD_USER).put_i32(user_id).put_string(name).put_string(email)
+                         .put_u32(static_cast<uint32_t>(role)));
+        return user_id;
+    }
+    
+    // Get user by ID
+    User* get_user(int user_id) {
+        ReadLock registry(registry_mutex);
+        return users.get(user_id);
+    }
+    
+    const User* get_user(int user_id) const {
+        ReadLock registry(registry_mutex);
+        return users.get(user_id);
+    }
+    
+    // Add an availability window under the user's shard lock. Throws
+    // std::runtime_error for windows outside CompactTime's range.
+    bool add_availability(int user_id, const TimeSlot& slot) {
+        CLOUDFIT_TIME_OP(ADD_AVAILABILITY, user_id, 0);
+        WriteLock shard(user_locks[shard_of(user_id)]);
+        User* user = get_user(user_id);
+        if (!user) return false;
+        
+        user->add_availability(slot);
+        log_mutation(LogEncoder(LogOp::ADD_AVAILABILITY).put_i32(user_id).put_u32(1).put_slot(slot));
+        return true;
+    }
+    
+    bool add_availability(int user_id, const std::vector<TimeSlot>& slots) {
+        CLOUDFIT_TIME_OP(ADD_AVAILABILITY, user_id, 0);
+        WriteLock shard(user_locks[shard_of(user_id)]);
+        User* user = get_user(user_id);
+        if (!user) return false;
+        
+        user->add_availability(slots);
+        LogEncoder record(LogOp::ADD_AVAILABILITY);
+        record.put_i32(user_id).put_u32(static_cast<uint32_t>(slots.size()));
+        for (const TimeSlot& slot : slots) {
+            record.put_slot(slot);
+        }
+        log_mutation(record);
+        return true;
+    }
+    
+    // Bulk add of windows already in minute form, e.g. from an importer
+    bool add_compact_availability(int user_id, std::vector<CompactSlot> slots) {
+        CLOUDFIT_TIME_OP(ADD_AVAILABILITY, user_id, 0);
+        WriteLock shard(user_locks[shard_of(user_id)]);
+        User* user = get_user(user_id);
+        if (!user) return false;
+        
+        if (wal) {
+            LogEncoder record(LogOp::ADD_AVAILABILITY);
+            record.put_i32(user_id).put_u32(static_cast<uint32_t>(slots.size()));
+            for (const CompactSlot& slot : slots) {
+                record.put_slot(CompactTime::to_time_slot(slot));
+            }
+            log_mutation(record);
+        }
+        user->add_compact_availability(std::move(slots));
+        return true;
+    }
+    
+    // Add a weekly availability rule under the user's shard lock
+    bool add_recurring_availability(int user_id, const RecurringAvailability& rule) {
+        CLOUDFIT_TIME_OP(ADD_AVAILABILITY, user_id, 0);
+        WriteLock shard(user_locks[shard_of(user_id)]);
+        User* user = get_user(user_id);
+        if (!user) return false;
+        
+        if (wal) {
+            LogEncoder record(LogOp::ADD_RECURRENCE);
+            record.put_i32(user_id).put_slot(CompactTime::to_time_slot(rule.span()));
+            const IntervalSet& windows = rule.get_windows();
+            record.put_u32(static_cast<uint32_t>(windows.size()));
+            for (size_t i = 0; i < windows.size(); ++i) {
+                record.put_u32(windows[i].start).put_u32(windows[i].end);
+            }
+            const IntervalSet& exceptions = rule.get_exceptions();
+            record.put_u32(static_cast<uint32_t>(exceptions.size()));
+            for (size_t i = 0; i < exceptions.size(); ++i) {
+                record.put_slot(CompactTime::to_time_slot(exceptions[i]));
+            }
+            log_mutation(record);
+        }
+        user->add_recurring_availability(rule);
+        return true;
+    }
+    
+    // Expand a user's weekly rules over a horizon and keep the result for
+    // queries inside it. Fails if the user is unknown or has no rules.
+    bool cache_recurring_availability(int user_id, const TimeSlot& horizon) {
+        WriteLock shard(user_locks[shard_of(user_id)]);
+        User* user = get_user(user_id);
+        return user && user->cache_recurring_availability(CompactTime::to_compact(horizon));
+    }
+    
+    // Turn on the 15-minute bitmap calendar for a user over a horizon. Fails if
+    // the user's availability or bookings are not quantum-aligned.
+    bool enable_calendar(int user_id, const TimeSlot& horizon) {
+        CLOUDFIT_TIME_OP(ENABLE_CALENDAR, user_id, 0);
+        WriteLock shard(user_locks[shard_of(user_id)]);
+        User* user = get_user(user_id);
+        return user && user->enable_calendar(CompactTime::to_compact(horizon));
+    }
+    
+    // Users with the given role, in id order, without allocating. The view is
+    // invalidated by the next add_user, so concurrent callers should use the
+    // copying get_hr_managers/get_interviewers instead.
+    UserSpan users_with_role(UserRole role) const {
+        ReadLock registry(registry_mutex);
+        const std::vector<User*>& by_role = role_index[static_cast<size_t>(role)];
+        return UserSpan(by_role.data(), by_role.data() + by_role.size());
+    }
+    
+    UserSpan hr_managers() const { return users_with_role(UserRole::HR_MANAGER); }
+    UserSpan interviewers() const { return users_with_role(UserRole::INTERVIEWER); }
+    
+    // Get all HR managers
+    std::vector<User*> get_hr_managers() {
+        ReadLock registry(registry_mutex);
+        return role_index[static_cast<size_t>(UserRole::HR_MANAGER)];
+    }
+    
+    // Get all interviewers
+    std::vector<User*> get_interviewers() {
+        ReadLock registry(registry_mutex);
+        return role_index[static_cast<size_t>(UserRole::INTERVIEWER)];
+    }
+    
+    // Schedule interview without throwing on rejection. On success the new
+    // id is stored in interview_id and ScheduleError::NONE is returned.
+    ScheduleError schedule_interview(const std::string& candidate_name,
+                                     const std::string& position,
+                                     int hr_manager_id,
+                                     int interviewer_id,
+                                     const TimeSlot& time_slot,
+                                     int& interview_id) {
+        CLOUDFIT_TIME_OP(SCHEDULE_INTERVIEW, hr_manager_id, interviewer_id);
+        auto shard_guard = lock_pair<WriteLock>(hr_manager_id, interviewer_id);
+        User* hr_manager = get_user(hr_manager_id);
+        User* interviewer = get_user(interviewer_id);
+        
+        ScheduleError error = validate_booking(hr_manager, interviewer, time_slot);
+        if (error != ScheduleError::NONE) {
+            CLOUDFIT_COUNT_REJECTION(error);
+            return error;
+        }
+        
+        interview_id = commit_interview(candidate_name, position, hr_manager, interviewer, time_slot);
+        return ScheduleError::NONE;
+    }
+    
+    // Schedule interview, throwing std::runtime_error on rejection
+    int schedule_interview(const std::string& candidate_name, 
+                          const std::string& position,
+                          int hr_manager_id, 
+                          int interviewer_id, 
+                          const TimeSlot& time_slot) {
+        int interview_id = 0;
+        ScheduleError error = schedule_interview(candidate_name, position, hr_manager_id,
+                                                 interviewer_id, time_slot, interview_id);
+        if (error != ScheduleError::NONE) {
+            throw std::runtime_error(schedule_error_to_string(error));
+        }
+        return interview_id;
+    }
+    
+    // Schedule a block of interviews in one pass. Each user is looked up once,
+    // requests are swept in start-time order to find overlaps within the batch,
+    // and every request gets its own result instead of an exception. With
+    // all_or_nothing set, nothing is committed unless every request is valid.
+    std::vector<ScheduleResult> schedule_batch(const ScheduleRequest* requests, size_t count,
+                                               bool all_or_nothing = false) {
+        CLOUDFIT_TIME_OP(SCHEDULE_BATCH, 0, 0);
+        std::vector<ScheduleResult> results(count, ScheduleResult{ScheduleError::NONE, 0});
+        
+        // Per-user state shared by all requests touching that user
+        struct BatchUser {
+            User* user;
+            bool has_booking;
+            uint32_t last_end;
+        };
+        std::unordered_map<int, BatchUser> batch_users;
+        
+        // Lock every shard the batch touches, then look each user up once
+        std::vector<size_t> shards;
+        shards.reserve(2 * count);
+        for (size_t i = 0; i < count; ++i) {
+            shards.push_back(shard_of(requests[i].hr_manager_id));
+            shards.push_back(shard_of(requests[i].interviewer_id));
+        }
+        auto shard_guard = lock_shards<WriteLock>(std::move(shards));
+        {
+            ReadLock registry(registry_mutex);
+            for (size_t i = 0; i < count; ++i) {
+                for (int user_id : {requests[i].hr_manager_id, requests[i].interviewer_id}) {
+                    if (batch_users.find(user_id) == batch_users.end()) {
+                        batch_users.emplace(user_id, BatchUser{users.get(user_id), false, 0});
+                    }
+                }
+            }
+        }
+        
+        // Validate each request against roles, availability and existing bookings
+        std::vector<size_t> order;
+        order.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            const ScheduleRequest& request = requests[i];
+            results[i].error = validate_booking(batch_users[request.hr_manager_id].user,
+                                                batch_users[request.interviewer_id].user,
+                                                request.time_slot);
+            if (results[i].error == ScheduleError::NONE) {
+                order.push_back(i);
+            } else {
+                CLOUDFIT_COUNT_REJECTION(results[i].error);
+            }
+        }
+        
+        // Sweep in start-time order. Accepted requests of one user never overlap,
+        // so the latest accepted one also has the latest end time.
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return requests[a].time_slot.start_time < requests[b].time_slot.start_time;
+        });
+        
+        bool failed = order.size() != count;
+        std::vector<size_t> accepted;
+        accepted.reserve(order.size());
+        for (size_t i : order) {
+            CompactSlot slot = CompactTime::to_compact(requests[i].time_slot);
+            BatchUser& hr_manager = batch_users[requests[i].hr_manager_id];
+            BatchUser& interviewer = batch_users[requests[i].interviewer_id];
+            
+            if ((hr_manager.has_booking && slot.start < hr_manager.last_end) ||
+                (interviewer.has_booking && slot.start < interviewer.last_end)) {
+                results[i].error = ScheduleError::BATCH_CONFLICT;
+                CLOUDFIT_COUNT_REJECTION(ScheduleError::BATCH_CONFLICT);
+                failed = true;
+                continue;
+            }
+            
+            hr_manager.has_booking = interviewer.has_booking = true;
+            hr_manager.last_end = interviewer.last_end = slot.end;
+            accepted.push_back(i);
+        }
+        
+        if (all_or_nothing && failed) {
+            for (size_t i : accepted) {
+                results[i].error = ScheduleError::BATCH_ABORTED;
+                CLOUDFIT_COUNT_REJECTION(ScheduleError::BATCH_ABORTED);
+            }
+            return results;
+        }
+        
+        // Commit in submission order from one reserved block, so the batch gets
+        // contiguous interview ids that follow the input
+        std::sort(accepted.begin(), accepted.end());
+        std::vector<Interview*> created;
+        created.reserve(accepted.size());
+        IdBlock ids = Interview::id_generator().reserve(static_cast<int>(accepted.size()));
+        {
+            WriteLock registry(registry_mutex);
+            for (size_t i : accepted) {
+                const ScheduleRequest& request = requests[i];
+                created.push_back(create_interview(ids.take(), request.candidate_name,
+                                                   request.position, request.hr_manager_id,
+                                                   request.interviewer_id, request.time_slot));
+            }
+        }
+        for (size_t k = 0; k < accepted.size(); ++k) {
+            const ScheduleRequest& request = requests[accepted[k]];
+            attach_interview(created[k], batch_users[request.hr_manager_id].user,
+                             batch_users[request.interviewer_id].user);
+            results[accepted[k]].interview_id = created[k]->get_id();
+        }
+        
+        return results;
+    }
+    
+    std::vector<ScheduleResult> schedule_batch(const std::vector<ScheduleRequest>& requests,
+                                               bool all_or_nothing = false) {
+        return schedule_batch(requests.data(), requests.size(), all_or_nothing);
+    }
+    
+    // For each slot, whether the user is available and has no active booking
+    // then. Takes the user's shard lock once for the whole list.
+    std::vector<char> free_slot_mask(int user_id, const std::vector<TimeSlot>& slots) const {
+        CLOUDFIT_TIME_OP(FREE_SLOT_MASK, user_id, 0);
+        std::vector<char> mask(slots.size(), 0);
+        ReadLock shard(user_locks[shard_of(user_id)]);
+        const User* user = get_user(user_id);
+        if (!user) return mask;
+        
+        for (size_t i = 0; i < slots.size(); ++i) {
+            if (!CompactTime::in_range(slots[i])) continue;
+            CompactSlot slot = CompactTime::to_compact(slots[i]);
+            mask[i] = user->is_available(slot) && !user->has_booking_conflict(slot);
+        }
+        return mask;
+    }
+    
+    // Check for scheduling conflicts
+    bool has_conflict(int user_id, const TimeSlot& time_slot) {
+        CLOUDFIT_TIME_OP(HAS_CONFLICT, user_id, 0);
+        ReadLock shard(user_locks[shard_of(user_id)]);
+        User* user = get_user(user_id);
+        if (!user) return false;
+        
+        return user->has_booking_conflict(time_slot);
+    }
+    
+    // Find up to max_slots free slots of the given duration, rounded up to
+    // whole minutes, inside the window where both users are available and
+    // neither has an active interview.
+    // Availability and bookings are sorted, so this is a single merge pass
+    // that starts at the window.
+    std::vector<TimeSlot> find_free_slots(int hr_manager_id, int interviewer_id,
+                                          std::chrono::system_clock::duration duration,
+                                          const TimeSlot& window, size_t max_slots) const {
+        CLOUDFIT_TIME_OP(FIND_FREE_SLOTS, hr_manager_id, interviewer_id);
+        std::vector<TimeSlot> slots;
+        auto shard_guard = lock_pair<ReadLock>(hr_manager_id, interviewer_id);
+        const User* hr_manager = get_user(hr_manager_id);
+        const User* interviewer = get_user(interviewer_id);
+        // Whole minutes, rounded up so no slot is shorter than asked for
+        auto rounded = std::chrono::duration_cast<std::chrono::minutes>(duration);
+        if (rounded < duration) rounded += std::chrono::minutes(1);
+        int64_t minutes = rounded.count();
+        if (!hr_manager || !interviewer || max_slots == 0 || minutes <= 0 ||
+            minutes > std::numeric_limits<uint32_t>::max()) {
+            return slots;
+        }
+        uint32_t length = static_cast<uint32_t>(minutes);
+        CompactSlot range = CompactTime::to_compact_within(window);
+        
+        // Bitmap fast path when both calendars cover an aligned request
+        const QuantumCalendar* hr_calendar = hr_manager->get_calendar();
+        const QuantumCalendar* int_calendar = interviewer->get_calendar();
+        if (hr_calendar && int_calendar && hr_calendar->covers(range) &&
+            int_calendar->covers(range) && length % QuantumCalendar::QUANTUM_MINUTES == 0) {
+            std::vector<CompactSlot> found;
+            QuantumCalendar::find_free(*hr_calendar, *int_calendar, range,
+                                       length / QuantumCalendar::QUANTUM_MINUTES, max_slots, found);
+            for (const CompactSlot& slot : found) {
+                slots.push_back(CompactTime::to_time_slot(slot));
+            }
+            return slots;
+        }
+        
+        // Union of both users' bookings that reach into the window
+        std::vector<CompactSlot> busy;
+        const BookingIndex& hr_bookings = hr_manager->get_active_bookings();
+        const BookingIndex& int_bookings = interviewer->get_active_bookings();
+        size_t hr_it = hr_bookings.first_ending_after(range.start);
+        size_t int_it = int_bookings.first_ending_after(range.start);
+        size_t hr_end = hr_bookings.first_starting_at(range.end);
+        size_t int_end = int_bookings.first_starting_at(range.end);
+        while (hr_it < hr_end || int_it < int_end) {
+            bool take_hr = int_it >= int_end ||
+                           (hr_it < hr_end && hr_bookings.start(hr_it) < int_bookings.start(int_it));
+            const BookingIndex& bookings = take_hr ? hr_bookings : int_bookings;
+            size_t index = take_hr ? hr_it++ : int_it++;
+            CompactSlot entry{bookings.start(index), bookings.end(index)};
+            if (!busy.empty() && entry.start <= busy.back().end) {
+                busy.back().end = std::max(busy.back().end, entry.end);
+            } else {
+                busy.push_back(entry);
+            }
+        }
+        
+        // Emit back-to-back slots from the start of a free gap
+        auto emit_gap = [&](uint32_t start, uint32_t end) {
+            while (slots.size() < max_slots && end - start >= length) {
+                slots.push_back(CompactTime::to_time_slot(CompactSlot{start, start + length}));
+                start += length;
+            }
+        };
+        
+        // Intersect both availability lists from the given first windows and
+        // subtract the busy intervals
+        auto intersect = [&](const auto& hr_avail, const auto& int_avail, size_t a, size_t b) {
+            size_t k = 0;
+            while (a < hr_avail.size() && b < int_avail.size() && slots.size() < max_slots) {
+                uint32_t start = std::max({hr_avail[a].start, int_avail[b].start, range.start});
+                uint32_t end = std::min({hr_avail[a].end, int_avail[b].end, range.end});
+                
+                if (start < end) {
+                    while (k < busy.size() && busy[k].end <= start) ++k;
+                    uint32_t cursor = start;
+                    for (size_t j = k; j < busy.size() && busy[j].start < end; ++j) {
+                        if (busy[j].start > cursor) emit_gap(cursor, busy[j].start);
+                        cursor = std::max(cursor, busy[j].end);
+                    }
+                    if (cursor < end) emit_gap(cursor, end);
+                }
+                
+                if (hr_avail[a].end < int_avail[b].end) ++a; else ++b;
+                if (end >= range.end) break;
+            }
+        };
+        
+        // Weekly rules are expanded over the window only
+        if (hr_manager->has_recurring_availability() || interviewer->has_recurring_availability()) {
+            std::vector<CompactSlot> hr_avail, int_avail;
+            hr_manager->available_windows(range, hr_avail);
+            interviewer->available_windows(range, int_avail);
+            intersect(hr_avail, int_avail, 0, 0);
+        } else {
+            const IntervalSet& hr_avail = hr_manager->get_compact_availability();
+            const IntervalSet& int_avail = interviewer->get_compact_availability();
+            intersect(hr_avail, int_avail, hr_avail.first_ending_after(range.start),
+                      int_avail.first_ending_after(range.start));
+        }
+        
+        return slots;
+    }
+    
+    // Phase one of a cross-scheduler booking: check this scheduler's side of
+    // each hold and book the time, so nothing else can take it before
+    // resolve_holds. Holds are checked in order, so later ones see earlier
+    // ones. Returns one result per hold.
+    std::vector<ScheduleError> reserve_holds(const std::vector<BookingHold>& holds) {
+        CLOUDFIT_TIME_OP(RESERVE_HOLDS, 0, 0);
+        std::vector<ScheduleError> errors(holds.size(), ScheduleError::NONE);
+        std::vector<size_t> shards;
+        shards.reserve(holds.size());
+        for (const BookingHold& hold : holds) {
+            shards.push_back(shard_of(local_user_of(hold)));
+        }
+        auto shard_guard = lock_shards<WriteLock>(std::move(shards));
+        
+        std::vector<User*> holders(holds.size(), nullptr);
+        {
+            ReadLock registry(registry_mutex);
+            for (size_t i = 0; i < holds.size(); ++i) {
+                holders[i] = users.get(local_user_of(holds[i]));
+            }
+        }
+        for (size_t i = 0; i < holds.size(); ++i) {
+            errors[i] = validate_hold(holders[i], holds[i].owner_side, holds[i].request.time_slot);
+            if (errors[i] == ScheduleError::NONE) {
+                holders[i]->add_active_booking(holds[i].interview_id, holds[i].request.time_slot);
+            } else {
+                CLOUDFIT_COUNT_REJECTION(errors[i]);
+            }
+        }
+        
+        WriteLock registry(registry_mutex);
+        for (size_t i = 0; i < holds.size(); ++i) {
+            if (errors[i] != ScheduleError::NONE) continue;
+            const BookingHold& hold = holds[i];
+            pending_holds.emplace(hold.interview_id, hold);
+            log_mutation(LogEncoder(LogOp::RESERVE_HOLD).put_i32(hold.interview_id)
+                             .put_u32(hold.owner_side ? 1 : 0).put_i32(hold.owner)
+                             .put_string(hold.request.candidate_name).put_string(hold.request.position)
+                             .put_i32(hold.request.hr_manager_id).put_i32(hold.request.interviewer_id)
+                             .put_slot(hold.request.time_slot));
+        }
+        return errors;
+    }
+    
+    // Phase two: commit or release holds placed by reserve_holds. Committing
+    // the HR manager's side creates the interview under the reserved id; the
+    // other side keeps the time as an external booking of the interviewer.
+    void resolve_holds(const std::vector<HoldDecision>& decisions) {
+        CLOUDFIT_TIME_OP(RESOLVE_HOLDS, 0, 0);
+        std::vector<BookingHold> holds;
+        std::vector<bool> commits;
+        holds.reserve(decisions.size());
+        {
+            WriteLock registry(registry_mutex);
+            for (const HoldDecision& decision : decisions) {
+                auto it = pending_holds.find(decision.interview_id);
+                if (it == pending_holds.end()) continue;
+                holds.push_back(std::move(it->second));
+                commits.push_back(decision.commit);
+                pending_holds.erase(it);
+            }
+        }
+        
+        std::vector<size_t> shards;
+        shards.reserve(holds.size());
+        for (const BookingHold& hold : holds) {
+            shards.push_back(shard_of(local_user_of(hold)));
+        }
+        auto shard_guard = lock_shards<WriteLock>(std::move(shards));
+        WriteLock registry(registry_mutex);
+        for (size_t i = 0; i < holds.size(); ++i) {
+            const BookingHold& hold = holds[i];
+            const ScheduleRequest& request = hold.request;
+            User* user = users.get(local_user_of(hold));
+            log_mutation(LogEncoder(LogOp::RESOLVE_HOLD).put_i32(hold.interview_id).put_u32(commits[i] ? 1 : 0));
+            if (!commits[i]) {
+                user->remove_active_booking(hold.interview_id, request.time_slot);
+                continue;
+            }
+            
+            // The owner also logs the interview it creates; replay finds it
+            // already made by this record and skips it
+            user->add_scheduled_interview(hold.interview_id);
+            if (hold.owner_side) {
+                create_interview(hold.interview_id, request.candidate_name, request.position,
+                                 request.hr_manager_id, request.interviewer_id, request.time_slot);
+            } else {
+                external_bookings.emplace(hold.interview_id,
+                                          ExternalBooking{user->get_id(), hold.owner, request.time_slot,
+                                                          true, false, request.time_slot});
+            }
+        }
+    }
+    
+    // Free an external booking's time because its owner cancelled the
+    // interview. The record stays so the interview can be reactivated.
+    bool release_external_booking(int interview_id) {
+        CLOUDFIT_TIME_OP(EXTERNAL_BOOKING, 0, 0);
+        return with_external_booking(interview_id, [&](ExternalBooking& booking, User* user) {
+            if (booking.active) user->remove_active_booking(interview_id, booking.slot);
+            booking.active = false;
+            user->remove_scheduled_interview(interview_id);
+            log_external_booking(interview_id, booking, user);
+        });
+    }
+    
+    // Follow the owner's status change of an external booking. Reactivating
+    // fails if the time has been booked since.
+    bool set_external_booking_active(int interview_id, bool active) {
+        CLOUDFIT_TIME_OP(EXTERNAL_BOOKING, 0, 0);
+        bool changed = false;
+        bool found = with_external_booking(interview_id, [&](ExternalBooking& booking, User* user) {
+            if (booking.moving) return;
+            if (active && !booking.active) {
+                if (user->has_booking_conflict(booking.slot)) return;
+                user->add_active_booking(interview_id, booking.slot);
+            } else if (!active && booking.active) {
+                user->remove_active_booking(interview_id, booking.slot);
+            }
+            if (active) user->add_scheduled_interview(interview_id);
+            booking.active = active;
+            changed = true;
+            log_external_booking(interview_id, booking, user);
+        });
+        return found && changed;
+    }
+    
+    // Whether an external booking is among its user's scheduled interviews
+    bool is_external_booking_listed(int interview_id) {
+        bool listed = false;
+        with_external_booking(interview_id, [&](ExternalBooking&, User* user) {
+            listed = user->get_scheduled_interviews().count(interview_id) > 0;
+        });
+        return listed;
+    }
+    
+    // Phase one of moving an active external booking: check the new slot and
+    // hold both it and the old one until finish_external_move. Overlapping
+    // slots are held as their union, since a user's bookings never overlap.
+    ScheduleError hold_external_move(int interview_id, const TimeSlot& new_slot) {
+        CLOUDFIT_TIME_OP(EXTERNAL_BOOKING, 0, 0);
+        ScheduleError error = ScheduleError::INVALID_USER;
+        with_external_booking(interview_id, [&](ExternalBooking& booking, User* user) {
+            if (!booking.active || booking.moving) return;
+            if (!CompactTime::in_range(new_slot)) {
+                error = ScheduleError::OUT_OF_RANGE;
+            } else if (!user->is_available(new_slot)) {
+                error = ScheduleError::INTERVIEWER_UNAVAILABLE;
+            } else if (user->has_booking_conflict(new_slot, interview_id)) {
+                error = ScheduleError::TIME_CONFLICT;
+            } else {
+                const TimeSlot& old_slot = booking.slot;
+                if (old_slot.start_time <= new_slot.end_time && new_slot.start_time <= old_slot.end_time) {
+                    user->remove_active_booking(interview_id, old_slot);
+                    user->add_active_booking(interview_id,
+                                             TimeSlot(std::min(old_slot.start_time, new_slot.start_time),
+                                                      std::max(old_slot.end_time, new_slot.end_time)));
+                } else {
+                    user->add_active_booking(interview_id, new_slot);
+                }
+                booking.moving = true;
+                booking.move_to = new_slot;
+                error = ScheduleError::NONE;
+                log_external_booking(interview_id, booking, user);
+            }
+        });
+        return error;
+    }
+    
+    // Phase two: keep the new slot on commit, otherwise the old one
+    bool finish_external_move(int interview_id, bool commit) {
+        CLOUDFIT_TIME_OP(EXTERNAL_BOOKING, 0, 0);
+        return with_external_booking(interview_id, [&](ExternalBooking& booking, User* user) {
+            if (!booking.moving) return;
+            const TimeSlot& old_slot = booking.slot;
+            const TimeSlot& new_slot = booking.move_to;
+            if (old_slot.start_time <= new_slot.end_time && new_slot.start_time <= old_slot.end_time) {
+                user->remove_active_booking(interview_id,
+                                            TimeSlot(std::min(old_slot.start_time, new_slot.start_time),
+                                                     std::max(old_slot.end_time, new_slot.end_time)));
+                user->add_active_booking(interview_id, commit ? new_slot : old_slot);
+            } else {
+                user->remove_active_booking(interview_id, commit ? old_slot : new_slot);
+            }
+            if (commit) booking.slot = new_slot;
+            booking.moving = false;
+            log_external_booking(interview_id, booking, user);
+        });
+    }
+    
+    // Interviews of a local user that other schedulers own, in id order
+    std::vector<ExternalInterview> get_external_interviews(int user_id) const {
+        std::vector<ExternalInterview> result;
+        ReadLock shard(user_locks[shard_of(user_id)]);
+        ReadLock registry(registry_mutex);
+        const User* user = users.get(user_id);
+        if (!user) return result;
+        
+        for (int interview_id : user->get_scheduled_interviews()) {
+            auto it = external_bookings.find(interview_id);
+            if (it != external_bookings.end()) {
+                result.push_back(ExternalInterview{interview_id, it->second.owner});
+            }
+        }
+        return result;
+    }
+    
+    // Write the snapshot file. Caller holds every shard lock and the registry.
+    void write_snapshot_locked(const std::string& path) const {
+        std::unordered_map<std::string, uint32_t> string_ids;
+        std::vector<uint64_t> string_offsets(1, 0);
+        std::string string_data;
+        auto intern = [&](const std::string& value) {
+            auto it = string_ids.find(value);
+            if (it != string_ids.end()) return it->second;
+            uint32_t id = static_cast<uint32_t>(string_offsets.size() - 1);
+            string_ids.emplace(value, id);
+            string_data += value;
+            string_offsets.push_back(string_data.size());
+            return id;
+        };
+        
+        // Pooled strings are identified by address, skipping the hash of the text
+        std::unordered_map<const std::string*, uint32_t> pooled_ids;
+        auto intern_pooled = [&](const std::string& pooled) {
+            auto it = pooled_ids.find(&pooled);
+            if (it != pooled_ids.end()) return it->second;
+            uint32_t id = intern(pooled);
+            pooled_ids.emplace(&pooled, id);
+            return id;
+        };
+        
+        std::vector<SnapshotUser> user_records;
+        std::vector<uint32_t> slot_starts;
+        std::vector<uint32_t> slot_ends;
+        std::vector<SnapshotRule> rule_records;
+        std::vector<uint32_t> window_starts;
+        std::vector<uint32_t> window_ends;
+        std::vector<int64_t> exception_times;
+        auto unix_seconds = [](uint32_t minutes) {
+            return static_cast<int64_t>(std::chrono::system_clock::to_time_t(CompactTime::from_minutes(minutes)));
+        };
+        users.for_each([&](const User* user) {
+            const IntervalSet& availability = user->get_compact_availability();
+            user_records.push_back(SnapshotUser{user->get_id(), static_cast<uint32_t>(user->get_role()),
+                                                intern_pooled(user->get_name()), intern_pooled(user->get_email()),
+                                                slot_starts.size(), availability.size()});
+            for (size_t i = 0; i < availability.size(); ++i) {
+                slot_starts.push_back(availability[i].start);
+                slot_ends.push_back(availability[i].end);
+            }
+            for (const RecurringAvailability& rule : user->get_recurring_availability()) {
+                const IntervalSet& windows = rule.get_windows();
+                const IntervalSet& exceptions = rule.get_exceptions();
+                rule_records.push_back(SnapshotRule{user->get_id(), 0, unix_seconds(rule.span().start),
+                                                    unix_seconds(rule.span().end), window_starts.size(),
+                                                    windows.size(), exception_times.size() / 2,
+                                                    exceptions.size()});
+                for (size_t i = 0; i < windows.size(); ++i) {
+                    window_starts.push_back(windows[i].start);
+                    window_ends.push_back(windows[i].end);
+                }
+                for (size_t i = 0; i < exceptions.size(); ++i) {
+                    exception_times.push_back(unix_seconds(exceptions[i].start));
+                    exception_times.push_back(unix_seconds(exceptions[i].end));
+                }
+            }
+        });
+        
+        // Start-time order lets the loader append to every index
+        std::vector<const Interview*> ordered;
+        ordered.reserve(interviews.size());
+        interviews.for_each([&](const Interview* interview) { ordered.push_back(interview); });
+        std::sort(ordered.begin(), ordered.end(), [](const Interview* a, const Interview* b) {
+            const TimeSlot& x = a->get_time_slot();
+            const TimeSlot& y = b->get_time_slot();
+            return x.start_time < y.start_time || (x.start_time == y.start_time && a->get_id() < b->get_id());
+        });
+        
+        std::vector<SnapshotInterview> interview_records;
+        interview_records.reserve(ordered.size());
+        for (const Interview* interview : ordered) {
+            const TimeSlot& slot = interview->get_time_slot();
+            uint32_t start_nanoseconds, end_nanoseconds;
+            int64_t start_seconds = split_unix_time(slot.start_time, start_nanoseconds);
+            int64_t end_seconds = split_unix_time(slot.end_time, end_nanoseconds);
+            interview_records.push_back(SnapshotInterview{
+                interview->get_id(), interview->get_hr_manager_id(), interview->get_interviewer_id(),
+                static_cast<uint32_t>(interview->get_status()), intern_pooled(interview->get_candidate_name()),
+                intern_pooled(interview->get_position()), intern(interview->get_notes()),
+                users.get(interview->get_interviewer_id()) ? 0 : SNAPSHOT_REMOTE_INTERVIEWER,
+                start_seconds, end_seconds, start_nanoseconds, end_nanoseconds});
+        }
+        
+        // Cross-scheduler state in id order
+        std::vector<SnapshotHold> hold_records;
+        for (const auto& entry : pending_holds) {
+            const BookingHold& hold = entry.second;
+            const ScheduleRequest& request = hold.request;
+            uint32_t start_nanoseconds, end_nanoseconds;
+            int64_t start_seconds = split_unix_time(request.time_slot.start_time, start_nanoseconds);
+            int64_t end_seconds = split_unix_time(request.time_slot.end_time, end_nanoseconds);
+            hold_records.push_back(SnapshotHold{
+                hold.interview_id, hold.owner, hold.owner_side ? 1u : 0u, intern(request.candidate_name),
+                intern(request.position), request.hr_manager_id, request.interviewer_id, 0,
+                start_seconds, end_seconds, start_nanoseconds, end_nanoseconds});
+        }
+        std::sort(hold_records.begin(), hold_records.end(),
+                  [](const SnapshotHold& a, const SnapshotHold& b) { return a.interview_id < b.interview_id; });
+        
+        std::vector<SnapshotExternal> external_records;
+        for (const auto& entry : external_bookings) {
+            const ExternalBooking& booking = entry.second;
+            const User* user = users.get(booking.user_id);
+            uint32_t nanoseconds[4];
+            int64_t start_seconds = split_unix_time(booking.slot.start_time, nanoseconds[0]);
+            int64_t end_seconds = split_unix_time(booking.slot.end_time, nanoseconds[1]);
+            int64_t move_start_seconds = split_unix_time(booking.move_to.start_time, nanoseconds[2]);
+            int64_t move_end_seconds = split_unix_time(booking.move_to.end_time, nanoseconds[3]);
+            external_records.push_back(SnapshotExternal{
+                entry.first, booking.user_id, booking.owner,
+                user ? external_flags(entry.first, booking, user) : 0,
+                start_seconds, end_seconds, move_start_seconds, move_end_seconds,
+                nanoseconds[0], nanoseconds[1], nanoseconds[2], nanoseconds[3]});
+        }
+        std::sort(external_records.begin(), external_records.end(),
+                  [](const SnapshotExternal& a, const SnapshotExternal& b) {
+                      return a.interview_id < b.interview_id;
+                  });
+        
+        SnapshotHeader header;
+        std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.version = SNAPSHOT_VERSION;
+        header.epoch_seconds = std::chrono::system_clock::to_time_t(CompactTime::get_epoch());
+        header.string_count = string_offsets.size() - 1;
+        header.string_bytes = string_data.size();
+        header.user_count = user_records.size();
+        header.slot_count = slot_starts.size();
+        header.interview_count = interview_records.size();
+        
+        std::string temp_path = path + ".tmp";
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("Cannot write " + temp_path);
+        
+        const char padding[8] = {};
+        auto write = [&](const void* data, size_t bytes) {
+            out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        };
+        auto pad = [&](size_t bytes) { write(padding, (8 - bytes % 8) % 8); };
+        
+        write(&header, sizeof(header));
+        write(string_offsets.data(), string_offsets.size() * sizeof(uint64_t));
+        write(string_data.data(), string_data.size());
+        pad(string_data.size());
+        write(user_records.data(), user_records.size() * sizeof(SnapshotUser));
+        write(slot_starts.data(), slot_starts.size() * sizeof(uint32_t));
+        write(slot_ends.data(), slot_ends.size() * sizeof(uint32_t));
+        pad(2 * slot_starts.size() * sizeof(uint32_t));
+        write(interview_records.data(), interview_records.size() * sizeof(SnapshotInterview));
+        
+        SnapshotRuleHeader rule_header{rule_records.size(), window_starts.size(), exception_times.size() / 2};
+        write(&rule_header, sizeof(rule_header));
+        write(rule_records.data(), rule_records.size() * sizeof(SnapshotRule));
+        write(window_starts.data(), window_starts.size() * sizeof(uint32_t));
+        write(window_ends.data(), window_ends.size() * sizeof(uint32_t));
+        pad(2 * window_starts.size() * sizeof(uint32_t));
+        write(exception_times.data(), exception_times.size() * sizeof(int64_t));
+        
+        // Archive segments are already encoded and go out as they are
+        std::vector<std::shared_ptr<const ArchiveSegment>> segments = archive.get_segments();
+        SnapshotArchiveHeader archive_header{segments.size()};
+        write(&archive_header, sizeof(archive_header));
+        for (const std::shared_ptr<const ArchiveSegment>& segment : segments) {
+            const std::vector<std::string>& strings = segment->get_strings();
+            std::vector<uint64_t> offsets(1, 0);
+            for (const std::string& value : strings) {
+                offsets.push_back(offsets.back() + value.size());
+            }
+            SnapshotSegment segment_header{segment->size(), segment->get_bytes().size(), strings.size(),
+                                           offsets.back()};
+            write(&segment_header, sizeof(segment_header));
+            write(segment->get_bytes().data(), segment->get_bytes().size());
+            pad(segment->get_bytes().size());
+            write(offsets.data(), offsets.size() * sizeof(uint64_t));
+            for (const std::string& value : strings) {
+                write(value.data(), value.size());
+            }
+            pad(static_cast<size_t>(offsets.back()));
+        }
+        
+        SnapshotExternalHeader external_header{hold_records.size(), external_records.size()};
+        write(&external_header, sizeof(external_header));
+        write(hold_records.data(), hold_records.size() * sizeof(SnapshotHold));
+        write(external_records.data(), external_records.size() * sizeof(SnapshotExternal));
+        
+        out.close();
+        if (!out || std::rename(temp_path.c_str(), path.c_str()) != 0) {
+            std::remove(temp_path.c_str());
+            throw std::runtime_error("Cannot write " + path);
+        }
+    }
+    
+    // Write users, availability, interviews and the local side of
+    // cross-scheduler bookings to a binary snapshot in one pass. The file is
+    // written next to path and renamed into place, so a reader never sees a
+    // partial snapshot. Bitmap calendars are not saved.
+    void save_snapshot(const std::string& path) const {
+        CLOUDFIT_TIME_OP(SAVE_SNAPSHOT, 0, 0);
+        auto shard_guard = lock_all_shards<ReadLock>();
+        ReadLock registry(registry_mutex);
+        write_snapshot_locked(path);
+    }
+    
+    // Load a snapshot written by save_snapshot into an empty scheduler. The
+    // file is memory-mapped and its records are read in place; objects go
+    // straight into the pools and indexes without per-booking validation.
+    // Throws on a malformed file, after which the scheduler should be discarded.
+    void load_snapshot(const std::string& path) {
+        CLOUDFIT_TIME_OP(LOAD_SNAPSHOT, 0, 0);
+        MappedFile file(path);
+        const char* data = file.data();
+        size_t size = file.size();
+        
+        auto corrupt = [&path]() { return std::runtime_error("Corrupt snapshot " + path); };
+        auto section = [&](size_t& offset, uint64_t count, size_t element) {
+            if (count > (size - offset) / element) throw corrupt();
+            const char* start = data + offset;
+            offset += static_cast<size_t>(count) * element;
+            return start;
+        };
+        auto align = [](size_t offset) { return (offset + 7) & ~static_cast<size_t>(7); };
+        
+        SnapshotHeader header;
+        if (size < sizeof(header)) throw corrupt();
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) throw corrupt();
+        if (header.version == 0 || header.version > SNAPSHOT_VERSION) {
+            throw std::runtime_error("Unsupported snapshot version in " + path);
+        }
+        
+        size_t offset = sizeof(header);
+        const uint64_t* string_offsets = reinterpret_cast<const uint64_t*>(
+            section(offset, header.string_count + 1, sizeof(uint64_t)));
+        const char* string_data = section(offset, header.string_bytes, 1);
+        offset = align(offset);
+        const char* user_data = section(offset, header.user_count, sizeof(SnapshotUser));
+        const uint32_t* slot_starts = reinterpret_cast<const uint32_t*>(
+            section(offset, header.slot_count, sizeof(uint32_t)));
+        const uint32_t* slot_ends = reinterpret_cast<const uint32_t*>(
+            section(offset, header.slot_count, sizeof(uint32_t)));
+        offset = align(offset);
+        // Records before version 6 end before their nanosecond fields
+        bool subsecond = header.version >= 6;
+        size_t interview_size = subsecond ? sizeof(SnapshotInterview) : offsetof(SnapshotInterview, start_nanoseconds);
+        size_t hold_size = subsecond ? sizeof(SnapshotHold) : offsetof(SnapshotHold, start_nanoseconds);
+        size_t external_size = subsecond ? sizeof(SnapshotExternal) : offsetof(SnapshotExternal, start_nanoseconds);
+        const char* interview_data = section(offset, header.interview_count, interview_size);
+        
+        SnapshotRuleHeader rule_header = SnapshotRuleHeader();
+        const char* rule_data = nullptr;
+        const uint32_t* window_starts = nullptr;
+        const uint32_t* window_ends = nullptr;
+        const int64_t* exception_times = nullptr;
+        if (header.version >= 2) {
+            std::memcpy(&rule_header, section(offset, 1, sizeof(rule_header)), sizeof(rule_header));
+            rule_data = section(offset, rule_header.rule_count, sizeof(SnapshotRule));
+            window_starts = reinterpret_cast<const uint32_t*>(
+                section(offset, rule_header.window_count, sizeof(uint32_t)));
+            window_ends = reinterpret_cast<const uint32_t*>(
+                section(offset, rule_header.window_count, sizeof(uint32_t)));
+            offset = align(offset);
+            if (rule_header.exception_count > std::numeric_limits<uint64_t>::max() / 2) throw corrupt();
+            exception_times = reinterpret_cast<const int64_t*>(
+                section(offset, 2 * rule_header.exception_count, sizeof(int64_t)));
+        }
+        
+        std::vector<std::shared_ptr<const ArchiveSegment>> segments;
+        if (header.version >= 3) {
+            SnapshotArchiveHeader archive_header;
+            std::memcpy(&archive_header, section(offset, 1, sizeof(archive_header)), sizeof(archive_header));
+            for (uint64_t i = 0; i < archive_header.segment_count; ++i) {
+                SnapshotSegment segment;
+                std::memcpy(&segment, section(offset, 1, sizeof(segment)), sizeof(segment));
+                const char* encoded = section(offset, segment.byte_count, 1);
+                offset = align(offset);
+                if (segment.string_count >= std::numeric_limits<uint64_t>::max() / sizeof(uint64_t)) throw corrupt();
+                const uint64_t* offsets = reinterpret_cast<const uint64_t*>(
+                    section(offset, segment.string_count + 1, sizeof(uint64_t)));
+                const char* chars = section(offset, segment.string_bytes, 1);
+                offset = align(offset);
+                
+                std::vector<std::string> strings;
+                strings.reserve(static_cast<size_t>(segment.string_count));
+                for (uint64_t k = 0; k < segment.string_count; ++k) {
+                    if (offsets[k] > offsets[k + 1] || offsets[k + 1] > segment.string_bytes) throw corrupt();
+                    strings.emplace_back(chars + offsets[k], static_cast<size_t>(offsets[k + 1] - offsets[k]));
+                }
+                std::shared_ptr<const ArchiveSegment> restored = std::make_shared<const ArchiveSegment>(
+                    static_cast<size_t>(segment.record_count),
+                    std::string(encoded, static_cast<size_t>(segment.byte_count)), std::move(strings),
+                    header.version >= 5);
+                if (!restored->intact()) throw corrupt();
+                segments.push_back(std::move(restored));
+            }
+        }
+        
+        SnapshotExternalHeader external_header = SnapshotExternalHeader();
+        const char* hold_data = nullptr;
+        const char* external_data = nullptr;
+        if (header.version >= 4) {
+            std::memcpy(&external_header, section(offset, 1, sizeof(external_header)), sizeof(external_header));
+            hold_data = section(offset, external_header.hold_count, hold_size);
+            external_data = section(offset, external_header.external_count, external_size);
+        }
+        
+        auto text = [&](uint32_t index) {
+            if (index >= header.string_count || string_offsets[index] > string_offsets[index + 1] ||
+                string_offsets[index + 1] > header.string_bytes) {
+                throw corrupt();
+            }
+            return std::string(string_data + string_offsets[index],
+                               static_cast<size_t>(string_offsets[index + 1] - string_offsets[index]));
+        };
+        
+        // Each string table entry is interned once, however many records use it
+        std::vector<const InternedString*> interned(static_cast<size_t>(header.string_count), nullptr);
+        std::deque<InternedString> interned_storage;
+        auto pooled = [&](uint32_t index) {
+            if (index < interned.size() && interned[index]) return *interned[index];
+            interned_storage.push_back(InternedString(text(index)));
+            interned[index] = &interned_storage.back();
+            return interned_storage.back();
+        };
+        
+        auto shard_guard = lock_all_shards<WriteLock>();
+        WriteLock registry(registry_mutex);
+        if (users.size() != 0 || interviews.size() != 0 || archive.size() != 0) {
+            throw std::runtime_error("Snapshot can only be loaded into an empty scheduler");
+        }
+        
+        // Slots were stored relative to the writer's epoch
+        int64_t epoch_shift = (header.epoch_seconds -
+                               std::chrono::system_clock::to_time_t(CompactTime::get_epoch())) / 60;
+        std::vector<uint32_t> shifted;
+        
+        int max_user_id = 0;
+        for (uint64_t i = 0; i < header.user_count; ++i) {
+            SnapshotUser record;
+            std::memcpy(&record, user_data + i * sizeof(record), sizeof(record));
+            if (record.id <= 0 || record.role > static_cast<uint32_t>(UserRole::INTERVIEWER) ||
+                record.first_slot > header.slot_count ||
+                record.slot_count > header.slot_count - record.first_slot) {
+                throw corrupt();
+            }
+            max_user_id = std::max(max_user_id, record.id);
+        }
+        users.reserve(max_user_id);
+        
+        for (uint64_t i = 0; i < header.user_count; ++i) {
+            SnapshotUser record;
+            std::memcpy(&record, user_data + i * sizeof(record), sizeof(record));
+            if (users.get(record.id)) throw corrupt();
+            
+            UserRole role = static_cast<UserRole>(record.role);
+            User* user = user_pool.get(user_pool.create(record.id, pooled(record.name), pooled(record.email), role));
+            users.insert(record.id, user);
+            role_index[record.role].push_back(user);
+            role_counts[record.role].fetch_add(1, std::memory_order_relaxed);
+            
+            const uint32_t* starts = slot_starts + record.first_slot;
+            const uint32_t* ends = slot_ends + record.first_slot;
+            size_t count = static_cast<size_t>(record.slot_count);
+            if (epoch_shift != 0) {
+                shifted.resize(2 * count);
+                for (size_t k = 0; k < count; ++k) {
+                    shifted[k] = CompactTime::to_minutes(CompactTime::from_minutes(starts[k]) +
+                                                         std::chrono::minutes(epoch_shift));
+                    shifted[count + k] = CompactTime::to_minutes(CompactTime::from_minutes(ends[k]) +
+                                                                 std::chrono::minutes(epoch_shift));
+                }
+                starts = shifted.data();
+                ends = shifted.data() + count;
+            }
+            if (!user->load_availability(starts, ends, count)) throw corrupt();
+        }
+        for (std::vector<User*>& by_role : role_index) {
+            std::sort(by_role.begin(), by_role.end(),
+                      [](const User* a, const User* b) { return a->get_id() < b->get_id(); });
+        }
+        
+        int max_interview_id = 0;
+        for (uint64_t i = 0; i < header.interview_count; ++i) {
+            SnapshotInterview record = SnapshotInterview();
+            std::memcpy(&record, interview_data + i * interview_size, interview_size);
+            if (record.id <= 0 || record.status > static_cast<uint32_t>(InterviewStatus::RESCHEDULED) ||
+                record.start_nanoseconds >= NANOSECONDS_PER_SECOND || record.end_nanoseconds >= NANOSECONDS_PER_SECOND) {
+                throw corrupt();
+            }
+            max_interview_id = std::max(max_interview_id, record.id);
+        }
+        interviews.reserve(max_interview_id);
+        hot_table.reserve(max_interview_id);
+        
+        for (uint64_t i = 0; i < header.interview_count; ++i) {
+            SnapshotInterview record = SnapshotInterview();
+            std::memcpy(&record, interview_data + i * interview_size, interview_size);
+            bool remote_interviewer = (record.flags & SNAPSHOT_REMOTE_INTERVIEWER) != 0;
+            User* hr_manager = users.get(record.hr_manager_id);
+            User* interviewer = remote_interviewer ? nullptr : users.get(record.interviewer_id);
+            if (!hr_manager || (!remote_interviewer && !interviewer) ||
+                (record.flags & ~SNAPSHOT_REMOTE_INTERVIEWER) != 0 || interviews.get(record.id)) {
+                throw corrupt();
+            }
+            
+            TimeSlot slot(join_unix_time(record.start_seconds, record.start_nanoseconds),
+                          join_unix_time(record.end_seconds, record.end_nanoseconds));
+            Interview* interview = interview_pool.get(
+                interview_pool.create(record.id, pooled(record.candidate_name), pooled(record.position),
+                                      record.hr_manager_id, record.interviewer_id, slot));
+            InterviewStatus status = static_cast<InterviewStatus>(record.status);
+            interview->set_status(status);
+            interview->set_notes(text(record.notes));
+            interviews.insert(record.id, interview);
+            status_counts[record.status].fetch_add(1, std::memory_order_relaxed);
+            time_index.insert(interview);
+            hot_table.update(interview);
+            publish(interview);
+            
+            // Same per-user bookkeeping as the scheduling and status paths
+            if (status != InterviewStatus::CANCELLED) {
+                hr_manager->add_scheduled_interview(record.id);
+                if (interviewer) interviewer->add_scheduled_interview(record.id);
+            }
+            if (interview->is_active()) {
+                hr_manager->add_active_booking(record.id, slot);
+                if (interviewer) interviewer->add_active_booking(record.id, slot);
+            }
+        }
+        
+        for (uint64_t i = 0; i < rule_header.rule_count; ++i) {
+            SnapshotRule record;
+            std::memcpy(&record, rule_data + i * sizeof(record), sizeof(record));
+            User* user = users.get(record.user_id);
+            if (!user || record.first_window > rule_header.window_count ||
+                record.window_count > rule_header.window_count - record.first_window ||
+                record.first_exception > rule_header.exception_count ||
+                record.exception_count > rule_header.exception_count - record.first_exception) {
+                throw corrupt();
+            }
+            
+            RecurringAvailability rule(
+                std::chrono::system_clock::from_time_t(static_cast<std::time_t>(record.anchor_seconds)),
+                std::chrono::system_clock::from_time_t(static_cast<std::time_t>(record.until_seconds)));
+            for (uint64_t k = record.first_window; k < record.first_window + record.window_count; ++k) {
+                if (window_starts[k] >= window_ends[k] || window_ends[k] > RecurringAvailability::WEEK_MINUTES) {
+                    throw corrupt();
+                }
+                rule.add_window(0, static_cast<int>(window_starts[k]), static_cast<int>(window_ends[k]));
+            }
+            for (uint64_t k = record.first_exception; k < record.first_exception + record.exception_count; ++k) {
+                rule.add_exception(TimeSlot(
+                    std::chrono::system_clock::from_time_t(static_cast<std::time_t>(exception_times[2 * k])),
+                    std::chrono::system_clock::from_time_t(static_cast<std::time_t>(exception_times[2 * k + 1]))));
+            }
+            user->add_recurring_availability(std::move(rule));
+        }
+        
+        auto slot_of = [&corrupt](int64_t start_seconds, uint32_t start_nanoseconds,
+                                  int64_t end_seconds, uint32_t end_nanoseconds) {
+            if (start_nanoseconds >= NANOSECONDS_PER_SECOND || end_nanoseconds >= NANOSECONDS_PER_SECOND) {
+                throw corrupt();
+            }
+            return TimeSlot(join_unix_time(start_seconds, start_nanoseconds),
+                            join_unix_time(end_seconds, end_nanoseconds));
+        };
+        for (uint64_t i = 0; i < external_header.hold_count; ++i) {
+            SnapshotHold record = SnapshotHold();
+            std::memcpy(&record, hold_data + i * hold_size, hold_size);
+            BookingHold hold{record.interview_id,
+                             ScheduleRequest{text(record.candidate_name), text(record.position),
+                                             record.hr_manager_id, record.interviewer_id,
+                                             slot_of(record.start_seconds, record.start_nanoseconds,
+                                                     record.end_seconds, record.end_nanoseconds)},
+                             record.owner_side != 0, record.owner};
+            User* user = users.get(local_user_of(hold));
+            if (!user || record.interview_id <= 0 || record.owner_side > 1 ||
+                knows_interview_locked(record.interview_id)) {
+                throw corrupt();
+            }
+            user->add_active_booking(hold.interview_id, hold.request.time_slot);
+            pending_holds.emplace(hold.interview_id, std::move(hold));
+            max_interview_id = std::max(max_interview_id, record.interview_id);
+        }
+        for (uint64_t i = 0; i < external_header.external_count; ++i) {
+            SnapshotExternal record = SnapshotExternal();
+            std::memcpy(&record, external_data + i * external_size, external_size);
+            User* user = users.get(record.user_id);
+            if (!user || record.interview_id <= 0 ||
+                record.flags > (EXTERNAL_ACTIVE | EXTERNAL_MOVING | EXTERNAL_LISTED) ||
+                (record.flags & (EXTERNAL_ACTIVE | EXTERNAL_MOVING)) == EXTERNAL_MOVING ||
+                knows_interview_locked(record.interview_id)) {
+                throw corrupt();
+            }
+            install_external_booking_locked(
+                record.interview_id,
+                ExternalBooking{record.user_id, record.owner,
+                                slot_of(record.start_seconds, record.start_nanoseconds,
+                                        record.end_seconds, record.end_nanoseconds),
+                                (record.flags & EXTERNAL_ACTIVE) != 0, (record.flags & EXTERNAL_MOVING) != 0,
+                                slot_of(record.move_start_seconds, record.move_start_nanoseconds,
+                                        record.move_end_seconds, record.move_end_nanoseconds)},
+                record.flags, user);
+            max_interview_id = std::max(max_interview_id, record.interview_id);
+        }
+        
+        // Archived interviews still count in the statistics
+        for (std::shared_ptr<const ArchiveSegment>& segment : segments) {
+            for (size_t status = 0; status < 4; ++status) {
+                status_counts[status].fetch_add(segment->status_count(static_cast<InterviewStatus>(status)),
+                                                std::memory_order_relaxed);
+            }
+            max_interview_id = std::max(max_interview_id, segment->max_id());
+            archive.restore(std::move(segment));
+        }
+        
+        User::id_generator().advance_past(max_user_id);
+        Interview::id_generator().advance_past(max_interview_id);
+    }
+    
+    // Start recording every mutation in a write-ahead log. Call before other
+    // threads use the scheduler and after replay_log; pass nullptr to detach.
+    void attach_log(WriteAheadLog* log) { wal = log; }
+    
+    // Re-apply the records of a log on top of the current state, typically a
+    // freshly loaded snapshot. Records the snapshot already covers converge
+    // to the same state. Stops at the first torn or corrupt record, which is
+    // where a crash interrupted the last batch. Returns the records applied.
+    size_t replay_log(const std::string& path) {
+        CLOUDFIT_TIME_OP(REPLAY_LOG, 0, 0);
+        if (wal) throw std::runtime_error("Replay the log before attaching it");
+        if (!std::ifstream(path)) return 0;
+        
+        MappedFile file(path);
+        const char* data = file.data();
+        size_t size = file.size();
+        size_t offset = 0;
+        size_t applied = 0;
+        
+        uint32_t header[2];
+        bool subsecond = false;
+        while (size - offset >= sizeof(header)) {
+            std::memcpy(header, data + offset, sizeof(header));
+            const char* payload = data + offset + sizeof(header);
+            if (header[0] > size - offset - sizeof(header) ||
+                WriteAheadLog::checksum(payload, header[0]) != header[1]) {
+                break;
+            }
+            
+            LogDecoder record(payload, header[0], subsecond);
+            if (!apply_log_record(record)) break;
+            if (static_cast<LogOp>(payload[0]) == LogOp::SUBSECOND_TIMES) subsecond = true;
+            offset += sizeof(header) + header[0];
+            ++applied;
+        }
+        return applied;
+    }
+    
+    // Fold the attached log into a snapshot: write the snapshot and empty
+    // the log while all mutations are held off.
+    void compact_log(const std::string& snapshot_path) {
+        CLOUDFIT_TIME_OP(COMPACT_LOG, 0, 0);
+        auto shard_guard = lock_all_shards<WriteLock>();
+        WriteLock registry(registry_mutex);
+        write_snapshot_locked(snapshot_path);
+        if (wal && !wal->truncate()) {
+            throw std::runtime_error("Cannot truncate log " + wal->get_path());
+        }
+    }
+    
+    // Get interview by ID, falling back to the archive
+    Interview* get_interview(int interview_id) {
+        {
+            ReadLock registry(registry_mutex);
+            if (Interview* interview = interviews.get(interview_id)) return interview;
+            auto it = archived_copies.find(interview_id);
+            if (it != archived_copies.end()) {
+                retired.renew(it->second);
+                return it->second;
+            }
+        }
+        std::unique_ptr<Interview> decoded = archive.get(interview_id);
+        if (!decoded) return nullptr;
+        WriteLock registry(registry_mutex);
+        return archived_copy_locked(*decoded);
+    }
+    
+    // Keeps every Interview pointer obtained while it is held valid
+    typedef RetireList::Guard ReadGuard;
+    ReadGuard read_guard() { return retired.enter(); }
+    
+    // Cancel interview
+    bool cancel_interview(int interview_id) {
+        CLOUDFIT_TIME_OP(CANCEL_INTERVIEW, 0, 0);
+        Interview* interview;
+        User* hr_manager;
+        User* interviewer;
+        PairLock<WriteLock> shard_guard;
+        if (!lock_interview(interview_id, shard_guard, interview, hr_manager, interviewer)) return false;
+        cancel_locked(interview, hr_manager, interviewer);
+        return true;
+    }
+    
+    // Replace an interview's notes
+    bool set_interview_notes(int interview_id, const std::string& notes) {
+        CLOUDFIT_TIME_OP(SET_NOTES, 0, 0);
+        Interview* interview;
+        User* hr_manager;
+        User* interviewer;
+        PairLock<WriteLock> shard_guard;
+        if (!lock_interview(interview_id, shard_guard, interview, hr_manager, interviewer)) return false;
+        interview->set_notes(notes);
+        publish(interview);
+        log_mutation(LogEncoder(LogOp::SET_NOTES).put_i32(interview_id).put_string(notes));
+        return true;
+    }
+    
+    // Move an active interview to a new time slot without throwing on
+    // rejection. Unknown and inactive interviews give INVALID_INTERVIEW.
+    ScheduleError reschedule_interview(int interview_id, const TimeSlot& new_slot) {
+        CLOUDFIT_TIME_OP(RESCHEDULE_INTERVIEW, 0, 0);
+        Interview* interview;
+        User* hr_manager;
+        User* interviewer;
+        PairLock<WriteLock> shard_guard;
+        ScheduleError error = ScheduleError::INVALID_INTERVIEW;
+        if (lock_interview(interview_id, shard_guard, interview, hr_manager, interviewer)) {
+            error = validate_move(interview, hr_manager, interviewer, new_slot);
+        }
+        if (error != ScheduleError::NONE) {
+            CLOUDFIT_COUNT_REJECTION(error);
+            return error;
+        }
+        
+        move_locked(interview, hr_manager, interviewer, new_slot);
+        set_status_locked(interview, InterviewStatus::RESCHEDULED);
+        return ScheduleError::NONE;
+    }
+    
+    // Move an interview, throwing std::runtime_error on rejection
+    void reschedule_interview_or_throw(int interview_id, const TimeSlot& new_slot) {
+        ScheduleError error = reschedule_interview(interview_id, new_slot);
+        if (error != ScheduleError::NONE) {
+            throw std::runtime_error(schedule_error_to_string(error));
+        }
+    }
+    
+    // Change an interview's status, keeping the conflict index in sync.
+    // Returns false if the interview is missing or reactivating it would conflict.
+    bool update_interview_status(int interview_id, InterviewStatus new_status) {
+        CLOUDFIT_TIME_OP(UPDATE_STATUS, 0, 0);
+        Interview* interview;
+        User* hr_manager;
+        User* interviewer;
+        PairLock<WriteLock> shard_guard;
+        if (!lock_interview(interview_id, shard_guard, interview, hr_manager, interviewer)) return false;
+        if (new_status == InterviewStatus::CANCELLED) {
+            cancel_locked(interview, hr_manager, interviewer);
+            return true;
+        }
+        
+        const TimeSlot& slot = interview->get_time_slot();
+        
+        bool was_active = interview->is_active();
+        bool will_be_active = new_status == InterviewStatus::SCHEDULED ||
+                              new_status == InterviewStatus::RESCHEDULED;
+        
+        if (!was_active && will_be_active) {
+            if ((hr_manager && hr_manager->has_booking_conflict(slot)) ||
+                (interviewer && interviewer->has_booking_conflict(slot))) {
+                return false;
+            }
+            if (hr_manager) {
+                hr_manager->add_scheduled_interview(interview_id);
+                hr_manager->add_active_booking(interview_id, slot);
+            }
+            if (interviewer) {
+                interviewer->add_scheduled_interview(interview_id);
+                interviewer->add_active_booking(interview_id, slot);
+            }
+        } else if (was_active && !will_be_active) {
+            if (hr_manager) hr_manager->remove_active_booking(interview_id, slot);
+            if (interviewer) interviewer->remove_active_booking(interview_id, slot);
+        }
+        
+        set_status_locked(interview, new_status);
+        return true;
+    }
+    
+    // Get all interviews for a user
+    std::vector<Interview*> get_user_interviews(int user_id) {
+        CLOUDFIT_TIME_OP(GET_USER_INTERVIEWS, user_id, 0);
+        std::vector<Interview*> user_interviews;
+        ReadLock shard(user_locks[shard_of(user_id)]);
+        ReadLock registry(registry_mutex);
+        User* user = users.get(user_id);
+        if (!user) return user_interviews;
+        
+        for (int interview_id : user->get_scheduled_interviews()) {
+            if (Interview* interview = interviews.get(interview_id)) {
+                user_interviews.push_back(interview);
+            }
+        }
+        return user_interviews;
+    }
+    
+    // Get all interviews
+    std::vector<Interview*> get_all_interviews() {
+        CLOUDFIT_TIME_OP(GET_ALL_INTERVIEWS, 0, 0);
+        std::vector<Interview*> all_interviews;
+        ReadLock registry(registry_mutex);
+        all_interviews.reserve(interviews.size());
+        interviews.for_each([&](Interview* interview) {
+            all_interviews.push_back(interview);
+        });
+        return all_interviews;
+    }
+    
+    // Interviews matching a filter, in id order. The scan runs over the hot
+    // table; only the matches are resolved to Interview objects.
+    std::vector<Interview*> find_interviews(const InterviewQuery& query) const {
+        CLOUDFIT_TIME_OP(FIND_INTERVIEWS, query.hr_manager_id, query.interviewer_id);
+        std::vector<int> ids = hot_table.select(query);
+        std::vector<Interview*> result;
+        result.reserve(ids.size());
+        ReadLock registry(registry_mutex);
+        for (int id : ids) {
+            if (Interview* interview = interviews.get(id)) result.push_back(interview);
+        }
+        return result;
+    }
+    
+    // Number of interviews matching a filter, without touching any Interview
+    size_t count_interviews(const InterviewQuery& query) const {
+        CLOUDFIT_TIME_OP(COUNT_INTERVIEWS, query.hr_manager_id, query.interviewer_id);
+        return hot_table.count(query);
+    }
+    
+    // Interviews for a position, in id order. Matching is a handle compare,
+    // and a position that was never interned has no interviews.
+    std::vector<Interview*> interviews_for_position(const std::string& position) const {
+        InternedString key;
+        if (!InternedString::lookup(position, key)) return std::vector<Interview*>();
+        
+        InterviewQuery query;
+        query.position = &key;
+        return find_interviews(query);
+    }
+    
+    // Interviews overlapping [start, end), archived ones included, ordered
+    // by start time
+    std::vector<Interview*> interviews_in_range(const std::chrono::system_clock::time_point& start,
+                                                const std::chrono::system_clock::time_point& end) {
+        CLOUDFIT_TIME_OP(RANGE_QUERY, 0, 0);
+        return with_archived(time_index.query(start, end), archive.in_range(start, end));
+    }
+    
+    // Interviews with the given status overlapping [start, end), archived
+    // ones included
+    std::vector<Interview*> interviews_in_range_for_status(
+            const std::chrono::system_clock::time_point& start,
+            const std::chrono::system_clock::time_point& end,
+            InterviewStatus status) {
+        CLOUDFIT_TIME_OP(RANGE_QUERY, 0, 0);
+        std::vector<Interview> archived;
+        if (status == InterviewStatus::COMPLETED || status == InterviewStatus::CANCELLED) {
+            archived = archive.in_range(start, end);
+            archived.erase(std::remove_if(archived.begin(), archived.end(), [status](const Interview& interview) {
+                return interview.get_status() != status;
+            }), archived.end());
+        }
+        return with_archived(time_index.query(start, end, status), std::move(archived));
+    }
+    
+    // Move COMPLETED and CANCELLED interviews that ended by horizon out of the
+    // live tables and indexes into the compressed archive. get_interview and
+    // the range queries still find them there, as do get_archived_interview
+    // and archived_in_range. Works in rounds of up to SEGMENT_RECORDS
+    // interviews, each holding every shard lock, so writers wait for one
+    // round at most. Archived objects are freed by a later call once no
+    // read_guard() can reach them. Statistics keep counting archived
+    // interviews; snapshot() views and the other queries hold live interviews
+    // only. Returns the number archived.
+    size_t archive_interviews(const std::chrono::system_clock::time_point& horizon) {
+        CLOUDFIT_TIME_OP(ARCHIVE_INTERVIEWS, 0, 0);
+        const size_t limit = InterviewArchive::SEGMENT_RECORDS;
+        size_t total = 0;
+        for (;;) {
+            auto shard_guard = lock_all_shards<WriteLock>();
+            WriteLock registry(registry_mutex);
+            if (total == 0) {
+                reclaim_retired_locked();
+                drop_finished_external_bookings(horizon);
+            }
+            
+            std::vector<Interview*> batch = time_index.ended_before(horizon, InterviewStatus::COMPLETED, limit);
+            std::vector<Interview*> cancelled = time_index.ended_before(horizon, InterviewStatus::CANCELLED, limit);
+            batch.insert(batch.end(), cancelled.begin(), cancelled.end());
+            std::sort(batch.begin(), batch.end(), [](const Interview* a, const Interview* b) {
+                const TimeSlot& x = a->get_time_slot();
+                const TimeSlot& y = b->get_time_slot();
+                return x.start_time < y.start_time || (x.start_time == y.start_time && a->get_id() < b->get_id());
+            });
+            if (batch.size() > limit) batch.resize(limit);
+            
+            size_t archived = archive_locked(batch);
+            total += archived;
+            if (archived < limit) return total;
+        }
+    }
+    
+    // Decoded copy of an archived interview, or null if it is not archived
+    std::unique_ptr<Interview> get_archived_interview(int interview_id) const {
+        return archive.get(interview_id);
+    }
+    
+    // Decoded copies of the archived interviews overlapping [start, end),
+    // ordered by start time
+    std::vector<Interview> archived_in_range(const std::chrono::system_clock::time_point& start,
+                                             const std::chrono::system_clock::time_point& end) const {
+        return archive.in_range(start, end);
+    }
+    
+    const InterviewArchive& get_archive() const { return archive; }
+    
+    // Immutable view of every live interview as of now, which readers can hold
+    // and iterate while writers carry on. The first call turns on version
+    // tracking with one pass over all interviews while writers are held off;
+    // later calls copy one pointer per 256 interview ids.
+    std::shared_ptr<const SchedulerView> snapshot() {
+        if (!versions.enabled()) {
+            auto shard_guard = lock_all_shards<WriteLock>();
+            ReadLock registry(registry_mutex);
+            if (!versions.enabled()) {
+                interviews.for_each([this](Interview* interview) { versions.update(interview); });
+                versions.enable();
+            }
+        }
+        return versions.view(role_counts[static_cast<size_t>(UserRole::HR_MANAGER)].load(std::memory_order_relaxed),
+                             role_counts[static_cast<size_t>(UserRole::INTERVIEWER)].load(std::memory_order_relaxed));
+    }
+    
+    // Snapshot of the maintained counters; O(1) and allocation free
+    SchedulerStats get_statistics() const {
+        auto role = [this](UserRole r) {
+            return role_counts[static_cast<size_t>(r)].load(std::memory_order_relaxed);
+        };
+        auto status = [this](InterviewStatus st) {
+            return status_counts[static_cast<size_t>(st)].load(std::memory_order_relaxed);
+        };
+        
+        SchedulerStats stats;
+        stats.hr_managers = role(UserRole::HR_MANAGER);
+        stats.interviewers = role(UserRole::INTERVIEWER);
+        stats.scheduled = status(InterviewStatus::SCHEDULED);
+        stats.completed = status(InterviewStatus::COMPLETED);
+        stats.cancelled = status(InterviewStatus::CANCELLED);
+        stats.rescheduled = status(InterviewStatus::RESCHEDULED);
+        return stats;
+    }
+    
+    // Display system statistics
+    void display_statistics() {
+        SchedulerStats stats = get_statistics();
+        
+        std::cout << "\n=== CLOUDFIT SCHEDULING STATISTICS ===\n";
+        std::cout << "Total Users: " << stats.total_users() << std::endl;
+        std::cout << "HR Managers: " << stats.hr_managers << std::endl;
+        std::cout << "Interviewers: " << stats.interviewers << std::endl;
+        std::cout << "Total Interviews: " << stats.total_interviews() << std::endl;
+        std::cout << "Scheduled: " << stats.scheduled << std::endl;
+        std::cout << "Completed: " << stats.completed << std::endl;
+        std::cout << "Cancelled: " << stats.cancelled << std::endl;
+        std::cout << "Rescheduled: " << stats.rescheduled << std::endl;
+        std::cout << "Archived: " << archive.size() << std::endl;
+        std::cout << "=======================================\n";
+    }
+};
+
+#ifdef CLOUDFIT_METRICS
+
+// Label for a rejection reason in exported metrics
+const char* schedule_error_label(ScheduleError error) {
+    switch (error) {
+        case ScheduleError::NONE: return "none";
+        case ScheduleError::INVALID_USER: return "invalid_user";
+        case ScheduleError::NOT_HR_MANAGER: return "not_hr_manager";
+        case ScheduleError::NOT_INTERVIEWER: return "not_interviewer";
+        case ScheduleError::HR_MANAGER_UNAVAILABLE: return "hr_manager_unavailable";
+        case ScheduleError::INTERVIEWER_UNAVAILABLE: return "interviewer_unavailable";
+        case ScheduleError::TIME_CONFLICT: return "time_conflict";
+        case ScheduleError::BATCH_CONFLICT: return "batch_conflict";
+        case ScheduleError::BATCH_ABORTED: return "batch_aborted";
+        case ScheduleError::NO_FEASIBLE_LOOP: return "no_feasible_loop";
+        case ScheduleError::BATCH_FAILED: return "batch_failed";
+        case ScheduleError::OUT_OF_RANGE: return "out_of_range";
+        case ScheduleError::INVALID_INTERVIEW: return "invalid_interview";
+        default: return "unknown";
+    }
+}
+
+static_assert(SCHEDULE_ERROR_COUNT <= SchedulerMetrics::REJECTION_REASONS,
+              "every ScheduleError needs a rejection counter");
+
+// Render collected metrics in the Prometheus text exposition format.
+// Latency histograms are only emitted for operations that were called.
+std::string metrics_to_prometheus(const SchedulerMetrics::Snapshot& snapshot) {
+    std::ostringstream out;
+    out << std::setprecision(12);
+    
+    // Upper bound of histogram bucket b, which holds values up to 2^b - 1
+    auto bound = [](size_t b) { return static_cast<double>((uint64_t(1) << b) - 1); };
+    
+    out << "# HELP cloudfit_scheduler_calls_total Calls of each Scheduler operation.\n"
+        << "# TYPE cloudfit_scheduler_calls_total counter\n";
+    for (size_t op = 0; op < SchedulerMetrics::OP_COUNT; ++op) {
+        out << "cloudfit_scheduler_calls_total{op=\"" << metric_op_name(static_cast<MetricOp>(op)) << "\"} "
+            << snapshot.calls[op] << "\n";
+    }
+    
+    out << "# HELP cloudfit_scheduler_latency_seconds Latency of each Scheduler operation, including lock waits.\n"
+        << "# TYPE cloudfit_scheduler_latency_seconds histogram\n";
+    const size_t first_latency_bucket = 6;
+    for (size_t op = 0; op < SchedulerMetrics::OP_COUNT; ++op) {
+        if (snapshot.calls[op] == 0) continue;
+        const char* name = metric_op_name(static_cast<MetricOp>(op));
+        uint64_t cumulative = 0;
+        for (size_t b = 0; b + 1 < SchedulerMetrics::LATENCY_BUCKETS; ++b) {
+            cumulative += snapshot.latency_buckets[op][b];
+            if (b < first_latency_bucket) continue;
+            out << "cloudfit_scheduler_latency_seconds_bucket{op=\"" << name << "\",le=\"" << bound(b) / 1e9
+                << "\"} " << cumulative << "\n";
+        }
+        out << "cloudfit_scheduler_latency_seconds_bucket{op=\"" << name << "\",le=\"+Inf\"} "
+            << snapshot.calls[op] << "\n"
+            << "cloudfit_scheduler_latency_seconds_sum{op=\"" << name << "\"} "
+            << snapshot.latency_sum_ns[op] / 1e9 << "\n"
+            << "cloudfit_scheduler_latency_seconds_count{op=\"" << name << "\"} " << snapshot.calls[op] << "\n";
+    }
+    
+    out << "# HELP cloudfit_schedule_rejections_total Booking requests rejected, by reason.\n"
+        << "# TYPE cloudfit_schedule_rejections_total counter\n";
+    for (size_t r = 1; r < SCHEDULE_ERROR_COUNT; ++r) {
+        out << "cloudfit_schedule_rejections_total{reason=\"" << schedule_error_label(static_cast<ScheduleError>(r))
+            << "\"} " << snapshot.rejections[r] << "\n";
+    }
+    
+    out << "# HELP cloudfit_conflict_scan_length Bookings examined by one conflict check.\n"
+        << "# TYPE cloudfit_conflict_scan_length histogram\n";
+    uint64_t cumulative = 0;
+    for (size_t b = 0; b + 1 < SchedulerMetrics::SCAN_BUCKETS; ++b) {
+        cumulative += snapshot.scan_buckets[b];
+        out << "cloudfit_conflict_scan_length_bucket{le=\"" << bound(b) << "\"} " << cumulative << "\n";
+    }
+    out << "cloudfit_conflict_scan_length_bucket{le=\"+Inf\"} " << snapshot.scan_count << "\n"
+        << "cloudfit_conflict_scan_length_sum " << snapshot.scan_sum << "\n"
+        << "cloudfit_conflict_scan_length_count " << snapshot.scan_count << "\n";
+    
+    out << "# HELP cloudfit_slow_call_seconds Slowest calls observed, with the users whose calendars they touched.\n"
+        << "# TYPE cloudfit_slow_call_seconds gauge\n";
+    for (const SchedulerMetrics::SlowCall& call : snapshot.slow_calls) {
+        out << "cloudfit_slow_call_seconds{op=\"" << metric_op_name(call.op) << "\",user=\"" << call.user_id
+            << "\",peer=\"" << call.peer_id << "\",scan=\"" << call.scan_length << "\"} "
+            << call.latency_ns / 1e9 << "\n";
+    }
+    
+    out << "# HELP cloudfit_metrics_threads Threads that have recorded metrics.\n"
+        << "# TYPE cloudfit_metrics_threads gauge\n"
+        << "cloudfit_metrics_threads " << snapshot.threads << "\n";
+    return out.str();
+}
+
+#endif
+
+// Users partitioned across several schedulers by a consistent hash of the
+// user id, each shard standing in for one node. An interview lives on its
+// HR manager's shard. When the interviewer is on another shard the booking
+// goes through a two-phase reserve/commit of BookingHolds, and a batch
+// calls each shard once per phase however many requests it holds. A shard's
+// snapshot and log cover its side of every cross-shard booking: the
+// interviews it owns, its external bookings and any holds still pending.
+class ShardedScheduler {
+private:
+    static const size_t VIRTUAL_NODES = 64;
+    static const size_t INTERVIEW_LOCKS = 64;
+    
+    std::vector<std::unique_ptr<Scheduler>> shards;
+    
+    // Hash ring of (point, shard) pairs, sorted by point
+    std::vector<std::pair<uint32_t, uint32_t>> ring;
+    
+    // Serialize status changes and moves of one interview across its shards
+    std::array<std::mutex, INTERVIEW_LOCKS> interview_locks;
+    
+    // Owning shard plus one for each interview id scheduled through here,
+    // zero if unknown
+    std::vector<uint32_t> owners;
+    mutable std::shared_timed_mutex owners_mutex;
+    
+    static uint32_t hash(uint64_t key) {
+        key += 0x9E3779B97F4A7C15ull;
+        key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ull;
+        key = (key ^ (key >> 27)) * 0x94D049BB133111EBull;
+        return static_cast<uint32_t>((key ^ (key >> 31)) >> 32);
+    }
+    
+    std::mutex& interview_lock(int interview_id) {
+        return interview_locks[static_cast<size_t>(interview_id) % INTERVIEW_LOCKS];
+    }
+    
+    void record_owner(int interview_id, size_t owner) {
+        size_t index = static_cast<size_t>(interview_id);
+        std::unique_lock<std::shared_timed_mutex> lock(owners_mutex);
+        if (index >= owners.size()) owners.resize(std::max(index + 1, 2 * owners.size()), 0);
+        owners[index] = static_cast<uint32_t>(owner) + 1;
+    }
+    
+    // Shard owning an interview, or -1. Ids the table has not seen, such as
+    // interviews loaded into a shard directly, are looked for on every shard
+    // and remembered once found.
+    int owner_of(int interview_id) {
+        if (interview_id <= 0) return -1;
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(owners_mutex);
+            size_t index = static_cast<size_t>(interview_id);
+            if (index < owners.size() && owners[index] != 0) return static_cast<int>(owners[index] - 1);
+        }
+        for (size_t i = 0; i < shards.size(); ++i) {
+            if (shards[i]->get_interview(interview_id)) {
+                record_owner(interview_id, i);
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+    
+    // Cancel on the owner, then free the interviewer's external booking.
+    // Caller holds the interview's lock.
+    bool cancel_locked(int interview_id, size_t owner, size_t other) {
+        bool cancelled = shards[owner]->cancel_interview(interview_id);
+        if (cancelled && other != owner) shards[other]->release_external_booking(interview_id);
+        return cancelled;
+    }
+
+public:
+    explicit ShardedScheduler(size_t shard_count) {
+        if (shard_count == 0) {
+            throw std::runtime_error("A sharded scheduler needs at least one shard");
+        }
+        for (size_t i = 0; i < shard_count; ++i) {
+            shards.emplace_back(new Scheduler());
+            for (size_t v = 0; v < VIRTUAL_NODES; ++v) {
+                ring.emplace_back(hash((static_cast<uint64_t>(i) << 32) | v), static_cast<uint32_t>(i));
+            }
+        }
+        std::sort(ring.begin(), ring.end());
+    }
+    
+    size_t shard_count() const { return shards.size(); }
+    Scheduler& shard(size_t index) { return *shards[index]; }
+    
+    // Shard of a user: the first ring point at or after the id's hash
+    size_t shard_of(int user_id) const {
+        uint32_t point = hash(static_cast<uint32_t>(user_id) | (uint64_t(1) << 63));
+        auto it = std::lower_bound(ring.begin(), ring.end(), std::make_pair(point, uint32_t(0)));
+        return it == ring.end() ? ring.front().second : it->second;
+    }
+    
+    // Add user on the shard its id hashes to
+    int add_user(const std::string& name, const std::string& email, UserRole role) {
+        int user_id = User::id_generator().next();
+        return shards[shard_of(user_id)]->add_user_with_id(user_id, name, email, role);
+    }
+    
+    User* get_user(int user_id) { return shards[shard_of(user_id)]->get_user(user_id); }
+    
+    bool add_availability(int user_id, const TimeSlot& slot) {
+        return shards[shard_of(user_id)]->add_availability(user_id, slot);
+    }
+    
+    bool add_availability(int user_id, const std::vector<TimeSlot>& slots) {
+        return shards[shard_of(user_id)]->add_availability(user_id, slots);
+    }
+    
+    bool add_recurring_availability(int user_id, const RecurringAvailability& rule) {
+        return shards[shard_of(user_id)]->add_recurring_availability(user_id, rule);
+    }
+    
+    bool cache_recurring_availability(int user_id, const TimeSlot& horizon) {
+        return shards[shard_of(user_id)]->cache_recurring_availability(user_id, horizon);
+    }
+    
+    // Schedule a block of interviews. Requests whose users share a shard go
+    // through that shard's batch path; the rest are reserved on both shards
+    // and committed only where both sides hold. Cross-shard requests only
+    // see the batch's same-shard bookings as existing interviews.
+    std::vector<ScheduleResult> schedule_batch(const std::vector<ScheduleRequest>& requests) {
+        std::vector<ScheduleResult> results(requests.size(), ScheduleResult{ScheduleError::NONE, 0});
+        size_t count = shards.size();
+        
+        std::vector<std::vector<ScheduleRequest>> local(count);
+        std::vector<std::vector<size_t>> local_index(count);
+        std::vector<size_t> cross;
+        for (size_t i = 0; i < requests.size(); ++i) {
+            size_t owner = shard_of(requests[i].hr_manager_id);
+            if (owner == shard_of(requests[i].interviewer_id)) {
+                local[owner].push_back(requests[i]);
+                local_index[owner].push_back(i);
+            } else {
+                cross.push_back(i);
+            }
+        }
+        for (size_t s = 0; s < count; ++s) {
+            if (local[s].empty()) continue;
+            std::vector<ScheduleResult> shard_results = shards[s]->schedule_batch(local[s]);
+            for (size_t k = 0; k < shard_results.size(); ++k) {
+                results[local_index[s][k]] = shard_results[k];
+                if (shard_results[k].error == ScheduleError::NONE) record_owner(shard_results[k].interview_id, s);
+            }
+        }
+        if (cross.empty()) return results;
+        
+        // Phase one: reserve both sides of every cross-shard request, one
+        // call per shard. Ids are reserved up front so both sides agree.
+        IdBlock ids = Interview::id_generator().reserve(static_cast<int>(cross.size()));
+        std::vector<int> interview_ids(cross.size());
+        std::vector<std::vector<BookingHold>> holds(count);
+        std::vector<std::vector<size_t>> hold_index(count);
+        for (size_t k = 0; k < cross.size(); ++k) {
+            const ScheduleRequest& request = requests[cross[k]];
+            size_t owner = shard_of(request.hr_manager_id);
+            size_t other = shard_of(request.interviewer_id);
+            interview_ids[k] = ids.take();
+            holds[owner].push_back(BookingHold{interview_ids[k], request, true, static_cast<int>(owner)});
+            hold_index[owner].push_back(k);
+            holds[other].push_back(BookingHold{interview_ids[k], request, false, static_cast<int>(owner)});
+            hold_index[other].push_back(k);
+        }
+        
+        std::vector<ScheduleError> owner_errors(cross.size(), ScheduleError::NONE);
+        std::vector<ScheduleError> other_errors(cross.size(), ScheduleError::NONE);
+        std::vector<std::vector<ScheduleError>> hold_errors(count);
+        for (size_t s = 0; s < count; ++s) {
+            if (holds[s].empty()) continue;
+            hold_errors[s] = shards[s]->reserve_holds(holds[s]);
+            for (size_t j = 0; j < holds[s].size(); ++j) {
+                (holds[s][j].owner_side ? owner_errors : other_errors)[hold_index[s][j]] = hold_errors[s][j];
+            }
+        }
+        
+        // Phase two: commit where both sides hold, release the rest
+        auto both_held = [&](size_t k) {
+            return owner_errors[k] == ScheduleError::NONE && other_errors[k] == ScheduleError::NONE;
+        };
+        for (size_t s = 0; s < count; ++s) {
+            std::vector<HoldDecision> decisions;
+            for (size_t j = 0; j < holds[s].size(); ++j) {
+                if (hold_errors[s][j] != ScheduleError::NONE) continue;
+                decisions.push_back(HoldDecision{holds[s][j].interview_id, both_held(hold_index[s][j])});
+            }
+            if (!decisions.empty()) shards[s]->resolve_holds(decisions);
+        }
+        
+        for (size_t k = 0; k < cross.size(); ++k) {
+            if (both_held(k)) {
+                results[cross[k]] = ScheduleResult{ScheduleError::NONE, interview_ids[k]};
+                record_owner(interview_ids[k], shard_of(requests[cross[k]].hr_manager_id));
+            } else {
+                ScheduleError error = owner_errors[k] != ScheduleError::NONE ? owner_errors[k] : other_errors[k];
+                results[cross[k]] = ScheduleResult{error, 0};
+            }
+        }
+        return results;
+    }
+    
+    // Schedule one interview without throwing on rejection
+    ScheduleError schedule_interview(const std::string& candidate_name, const std::string& position,
+                                     int hr_manager_id, int interviewer_id, const TimeSlot& time_slot,
+                                     int& interview_id) {
+        std::vector<ScheduleRequest> requests(
+            1, ScheduleRequest{candidate_name, position, hr_manager_id, interviewer_id, time_slot});
+        ScheduleResult result = schedule_batch(requests)[0];
+        if (result.error == ScheduleError::NONE) interview_id = result.interview_id;
+        return result.error;
+    }
+    
+    // Interview by id, from whichever shard owns it, archived or not
+    Interview* get_interview(int interview_id) {
+        int owner = owner_of(interview_id);
+        return owner < 0 ? nullptr : shards[owner]->get_interview(interview_id);
+    }
+    
+    // One read guard per shard; see Scheduler::read_guard
+    std::vector<Scheduler::ReadGuard> read_guard() {
+        std::vector<Scheduler::ReadGuard> guards;
+        guards.reserve(shards.size());
+        for (const std::unique_ptr<Scheduler>& scheduler : shards) {
+            guards.push_back(scheduler->read_guard());
+        }
+        return guards;
+    }
+    
+    bool cancel_interview(int interview_id) {
+        std::lock_guard<std::mutex> lock(interview_lock(interview_id));
+        int owner = owner_of(interview_id);
+        if (owner < 0) return false;
+        Interview* interview = shards[owner]->get_interview(interview_id);
+        return cancel_locked(interview_id, owner, shard_of(interview->get_interviewer_id()));
+    }
+    
+    // Change an interview's status on both shards. Reactivation books the
+    // interviewer's side first and is undone if the owner refuses it.
+    bool update_interview_status(int interview_id, InterviewStatus new_status) {
+        std::lock_guard<std::mutex> lock(interview_lock(interview_id));
+        int owner = owner_of(interview_id);
+        if (owner < 0) return false;
+        Interview* interview = shards[owner]->get_interview(interview_id);
+        size_t other = shard_of(interview->get_interviewer_id());
+        if (new_status == InterviewStatus::CANCELLED) return cancel_locked(interview_id, owner, other);
+        if (other == static_cast<size_t>(owner)) {
+            return shards[owner]->update_interview_status(interview_id, new_status);
+        }
+        
+        bool was_active = interview->is_active();
+        bool was_listed = shards[other]->is_external_booking_listed(interview_id);
+        bool will_be_active = new_status == InterviewStatus::SCHEDULED ||
+                              new_status == InterviewStatus::RESCHEDULED;
+        if (will_be_active) {
+            if (!shards[other]->set_external_booking_active(interview_id, true)) return false;
+            if (!shards[owner]->update_interview_status(interview_id, new_status)) {
+                if (!was_listed) {
+                    shards[other]->release_external_booking(interview_id);
+                } else if (!was_active) {
+                    shards[other]->set_external_booking_active(interview_id, false);
+                }
+                return false;
+            }
+            return true;
+        }
+        if (!shards[owner]->update_interview_status(interview_id, new_status)) return false;
+        shards[other]->set_external_booking_active(interview_id, false);
+        return true;
+    }
+    
+    // Move an active interview, holding the interviewer's new slot before the
+    // owner moves and releasing it if the owner rejects the move. Returns the
+    // rejection like Scheduler::reschedule_interview.
+    ScheduleError reschedule_interview(int interview_id, const TimeSlot& new_slot) {
+        std::lock_guard<std::mutex> lock(interview_lock(interview_id));
+        int owner = owner_of(interview_id);
+        if (owner < 0) return ScheduleError::INVALID_INTERVIEW;
+        Interview* interview = shards[owner]->get_interview(interview_id);
+        size_t other = shard_of(interview->get_interviewer_id());
+        if (other == static_cast<size_t>(owner)) {
+            return shards[owner]->reschedule_interview(interview_id, new_slot);
+        }
+        if (!interview->is_active()) return ScheduleError::INVALID_INTERVIEW;
+        
+        ScheduleError error = shards[other]->hold_external_move(interview_id, new_slot);
+        if (error != ScheduleError::NONE) return error;
+        try {
+            error = shards[owner]->reschedule_interview(interview_id, new_slot);
+        } catch (...) {
+            shards[other]->finish_external_move(interview_id, false);
+            throw;
+        }
+        shards[other]->finish_external_move(interview_id, error == ScheduleError::NONE);
+        return error;
+    }
+    
+    // Move an interview, throwing std::runtime_error on rejection
+    void reschedule_interview_or_throw(int interview_id, const TimeSlot& new_slot) {
+        ScheduleError error = reschedule_interview(interview_id, new_slot);
+        if (error != ScheduleError::NONE) {
+            throw std::runtime_error(schedule_error_to_string(error));
+        }
+    }
+    
+    // Archive finished interviews on every shard with one horizon, so both
+    // sides of a cross-shard booking go together. Holds every interview lock,
+    // so no status change or move runs in between.
+    size_t archive_interviews(const std::chrono::system_clock::time_point& horizon) {
+        std::vector<std::unique_lock<std::mutex>> locks;
+        locks.reserve(INTERVIEW_LOCKS);
+        for (std::mutex& lock : interview_locks) {
+            locks.emplace_back(lock);
+        }
+        size_t archived = 0;
+        for (const std::unique_ptr<Scheduler>& scheduler : shards) {
+            archived += scheduler->archive_interviews(horizon);
+        }
+        return archived;
+    }
+    
+    std::unique_ptr<Interview> get_archived_interview(int interview_id) const {
+        for (const std::unique_ptr<Scheduler>& scheduler : shards) {
+            if (std::unique_ptr<Interview> interview = scheduler->get_archived_interview(interview_id)) {
+                return interview;
+            }
+        }
+        return nullptr;
+    }
+    
+    std::vector<Interview> archived_in_range(const std::chrono::system_clock::time_point& start,
+                                             const std::chrono::system_clock::time_point& end) const {
+        std::vector<Interview> result;
+        for (const std::unique_ptr<Scheduler>& scheduler : shards) {
+            std::vector<Interview> part = scheduler->archived_in_range(start, end);
+            result.insert(result.end(), part.begin(), part.end());
+        }
+        std::stable_sort(result.begin(), result.end(), [](const Interview& a, const Interview& b) {
+            return a.get_time_slot().start_time < b.get_time_slot().start_time;
+        });
+        return result;
+    }
+    
+    // All interviews of a user, including those owned by other shards, in id order
+    std::vector<Interview*> get_user_interviews(int user_id) {
+        Scheduler& home = *shards[shard_of(user_id)];
+        std::vector<Interview*> result = home.get_user_interviews(user_id);
+        for (const ExternalInterview& external : home.get_external_interviews(user_id)) {
+            if (Interview* interview = shards[external.owner]->get_interview(external.interview_id)) {
+                result.push_back(interview);
+            }
+        }
+        std::sort(result.begin(), result.end(), [](const Interview* a, const Interview* b) {
+            return a->get_id() < b->get_id();
+        });
+        return result;
+    }
+    
+    // Counters summed over shards; each interview counts on its owner only
+    SchedulerStats get_statistics() const {
+        SchedulerStats total = SchedulerStats();
+        for (const std::unique_ptr<Scheduler>& scheduler : shards) {
+            SchedulerStats stats = scheduler->get_statistics();
+            total.hr_managers += stats.hr_managers;
+            total.interviewers += stats.interviewers;
+            total.scheduled += stats.scheduled;
+            total.completed += stats.completed;
+            total.cancelled += stats.cancelled;
+            total.rescheduled += stats.rescheduled;
+        }
+        return total;
+    }
+};
+
+// Bounded multi-producer, single-consumer queue. Every cell carries a
+// sequence number: producers claim a position with one CAS on the tail and
+// publish the cell by advancing its sequence, the consumer takes cells in
+// order and hands them back one lap ahead. No locks are taken on either side.
+template <typename T>
+class MpscRing {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+    
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> tail;   // next position to claim (producers)
+    alignas(64) size_t head;                // next position to take (consumer only)
+    
+    T* item(Cell& cell) { return reinterpret_cast<T*>(&cell.storage); }
+
+public:
+    // Capacity is rounded up to a power of two
+    explicit MpscRing(size_t capacity) : mask(0), tail(0), head(0) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        cells.reset(new Cell[size]);
+        mask = size - 1;
+        for (size_t i = 0; i < size; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+    
+    ~MpscRing() {
+        while (pop([](T&&) {})) {}
+    }
+    
+    size_t capacity() const { return mask + 1; }
+    
+    // Enqueue from any thread; false when the ring is full
+    bool try_push(T&& value) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[position & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t lag = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (lag == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            } else if (lag < 0) {
+                return false;
+            } else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+        new (item(*cell)) T(std::move(value));
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Consumer only: whether the next cell has been published
+    bool empty() {
+        return cells[head & mask].sequence.load(std::memory_order_acquire) != head + 1;
+    }
+    
+    // Consumer only: pass the oldest element to fn by rvalue and remove it
+    template <typename Fn>
+    bool pop(Fn&& fn) {
+        Cell& cell = cells[head & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != head + 1) return false;
+        T* value = item(cell);
+        fn(std::move(*value));
+        value->~T();
+        cell.sequence.store(head + mask + 1, std::memory_order_release);
+        ++head;
+        return true;
+    }
+};
+
+// Asynchronous booking front end for a Scheduler or ShardedScheduler. Any
+// number of threads submit requests into a lock-free ring; one worker thread
+// drains whatever has queued up (at most max_batch at a time) and books it
+// with a single schedule_batch call, so a burst of concurrent clients costs a
+// few shard lock rounds instead of one per request. Requests that overlap
+// inside one batch are settled by start time, as schedule_batch does.
+//
+// Results come back through a future or a callback. Callbacks run on the
+// worker thread and should be short. The destructor books everything already
+// queued before it returns; submitting while it runs is not allowed.
+template <typename Backend>
+class SchedulingPipeline {
+public:
+    typedef std::function<void(const ScheduleResult&)> Callback;
+
+private:
+    // Queued request with the way to report its result
+    struct Task {
+        ScheduleRequest request;
+        Callback callback;
+        std::unique_ptr<std::promise<ScheduleResult>> promise;
+    };
+    
+    Backend& backend;
+    MpscRing<Task> ring;
+    size_t max_batch;
+    std::atomic<bool> running;
+    std::atomic<bool> worker_idle;
+    std::atomic<uint64_t> batches;
+    std::atomic<uint64_t> requests;
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    std::thread worker;
+    
+    // Wake the worker if it went to sleep on an empty ring. The fence orders
+    // the published cell before the idle check; the worker sets idle before
+    // its last look at the ring, so one side always sees the other.
+    void notify_worker() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (worker_idle.load(std::memory_order_seq_cst)) {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            wake.notify_one();
+        }
+    }
+    
+    void enqueue(Task&& task) {
+        while (!ring.try_push(std::move(task))) {
+            notify_worker();
+            std::this_thread::yield();
+        }
+        notify_worker();
+    }
+    
+    static void complete(Task& task, const ScheduleResult& result) {
+        if (task.promise) task.promise->set_value(result);
+        if (task.callback) {
+            try {
+                task.callback(result);
+            } catch (...) {
+                // A throwing callback must not take the worker down
+            }
+        }
+    }
+    
+    void run() {
+        std::vector<Task> tasks;
+        std::vector<ScheduleRequest> batch;
+        tasks.reserve(max_batch);
+        batch.reserve(max_batch);
+        
+        for (;;) {
+            while (tasks.size() < max_batch && ring.pop([&](Task&& task) { tasks.push_back(std::move(task)); })) {}
+            
+            if (tasks.empty()) {
+                if (!running.load(std::memory_order_acquire)) return;
+                std::unique_lock<std::mutex> lock(wake_mutex);
+                worker_idle.store(true, std::memory_order_seq_cst);
+                if (ring.empty() && running.load(std::memory_order_acquire)) {
+                    wake.wait_for(lock, std::chrono::milliseconds(10));
+                }
+                worker_idle.store(false, std::memory_order_relaxed);
+                continue;
+            }
+            
+            batch.clear();
+            for (Task& task : tasks) {
+                batch.push_back(std::move(task.request));
+            }
+            
+            std::vector<ScheduleResult> results;
+            try {
+                results = backend.schedule_batch(batch);
+            } catch (...) {
+                // Out of memory or similar: futures of the batch get the
+                // exception and callbacks a BATCH_FAILED result
+                std::exception_ptr error = std::current_exception();
+                for (Task& task : tasks) {
+                    if (task.promise) {
+                        task.promise->set_exception(error);
+                        task.promise.reset();
+                    }
+                    CLOUDFIT_COUNT_REJECTION(ScheduleError::BATCH_FAILED);
+                    complete(task, ScheduleResult{ScheduleError::BATCH_FAILED, 0});
+                }
+                tasks.clear();
+                continue;
+            }
+            
+            for (size_t i = 0; i < tasks.size(); ++i) {
+                complete(tasks[i], results[i]);
+            }
+            batches.fetch_add(1, std::memory_order_relaxed);
+            requests.fetch_add(tasks.size(), std::memory_order_relaxed);
+            tasks.clear();
+        }
+    }
+
+public:
+    explicit SchedulingPipeline(Backend& backend, size_t capacity = 65536, size_t max_batch = 1024)
+        : backend(backend), ring(capacity), max_batch(std::max<size_t>(max_batch, 1)), running(true),
+          worker_idle(false), batches(0), requests(0) {
+        worker = std::thread(&SchedulingPipeline::run, this);
+    }
+    
+    SchedulingPipeline(const SchedulingPipeline&) = delete;
+    SchedulingPipeline& operator=(const SchedulingPipeline&) = delete;
+    
+    ~SchedulingPipeline() {
+        running.store(false, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            wake.notify_one();
+        }
+        worker.join();
+    }
+    
+    // Queue a booking and get its result later; waits while the ring is full
+    std::future<ScheduleResult> submit(ScheduleRequest request) {
+        Task task{std::move(request), Callback(), std::make_unique<std::promise<ScheduleResult>>()};
+        std::future<ScheduleResult> result = task.promise->get_future();
+        enqueue(std::move(task));
+        return result;
+    }
+    
+    // Queue a booking whose result is passed to callback; waits while the ring is full
+    void submit(ScheduleRequest request, Callback callback) {
+        enqueue(Task{std::move(request), std::move(callback), nullptr});
+    }
+    
+    // Queue a booking unless the ring is full
+    bool try_submit(ScheduleRequest request, Callback callback) {
+        Task task{std::move(request), std::move(callback), nullptr};
+        if (!ring.try_push(std::move(task))) return false;
+        notify_worker();
+        return true;
+    }
+    
+    uint64_t batch_count() const { return batches.load(std::memory_order_relaxed); }
+    uint64_t request_count() const { return requests.load(std::memory_order_relaxed); }
+};
+
+// Background archiving for a Scheduler or ShardedScheduler. Every period a
+// worker thread archives the finished interviews that ended more than age
+// ago, so the live tables stay at the size of the active workload. The
+// destructor stops the worker after the run in progress, if any.
+template <typename Backend>
+class ArchiveCompactor {
+private:
+    Backend& backend;
+    std::chrono::system_clock::duration age;
+    std::chrono::milliseconds period;
+    std::atomic<uint64_t> archived;
+    bool stopping;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread worker;
+    
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping) {
+            lock.unlock();
+            archived.fetch_add(backend.archive_interviews(std::chrono::system_clock::now() - age),
+                               std::memory_order_relaxed);
+            lock.lock();
+            wake.wait_for(lock, period, [this] { return stopping; });
+        }
+    }
+
+public:
+    ArchiveCompactor(Backend& backend, std::chrono::system_clock::duration age, std::chrono::milliseconds period)
+        : backend(backend), age(age), period(period), archived(0), stopping(false) {
+        worker = std::thread(&ArchiveCompactor::run, this);
+    }
+    
+    ArchiveCompactor(const ArchiveCompactor&) = delete;
+    ArchiveCompactor& operator=(const ArchiveCompactor&) = delete;
+    
+    ~ArchiveCompactor() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+    
+    // Interviews archived by this compactor so far
+    uint64_t archived_count() const { return archived.load(std::memory_order_relaxed); }
+};
+
+// Candidate to place during a hiring event
+struct AssignmentCandidate {
+    std::string candidate_name;
+    std::string position;
+    std::vector<int> interviewer_ids;   // Interviewers allowed to run this interview
+};
+
+// Hiring event: candidates, the shared HR manager pool and the slot grid
+struct AssignmentProblem {
+    std::vector<AssignmentCandidate> candidates;
+    std::vector<int> hr_manager_ids;
+    std::chrono::system_clock::duration duration;
+    TimeSlot window;
+    
+    AssignmentProblem(std::chrono::system_clock::duration duration, const TimeSlot& window)
+        : duration(duration), window(window) {}
+};
+
+// Conflict-free schedule produced by AssignmentEngine::plan
+struct AssignmentPlan {
+    std::vector<ScheduleRequest> bookings;
+    std::vector<size_t> placed;         // Candidate index of each booking
+    std::vector<size_t> unplaced;
+};
+
+// Bulk assignment for hiring events. The window is cut into back-to-back
+// slots of the interview duration, and the placement is a maximum flow:
+//
+//   source -> candidate group -> (interviewer, slot) -> slot -> sink
+//
+// Candidates with the same interviewer set share one group node, an
+// (interviewer, slot) node exists only where that interviewer is free, and a
+// slot's capacity is the number of HR managers free in it. The flow is
+// therefore the largest number of candidates that can be placed on the grid
+// without conflicts.
+class AssignmentEngine {
+private:
+    // Dinic max flow over an adjacency-list graph
+    class FlowGraph {
+    private:
+        struct Edge {
+            int to;
+            int rev;
+            int cap;
+        };
+        
+        std::vector<std::vector<Edge>> adj;
+        std::vector<int> level;
+        std::vector<size_t> next_edge;
+        
+        bool build_levels(int source, int sink) {
+            level.assign(adj.size(), -1);
+            std::vector<int> queue(1, source);
+            level[source] = 0;
+            for (size_t head = 0; head < queue.size(); ++head) {
+                int node = queue[head];
+                for (const Edge& edge : adj[node]) {
+                    if (edge.cap > 0 && level[edge.to] < 0) {
+                        level[edge.to] = level[node] + 1;
+                        queue.push_back(edge.to);
+                    }
+                }
+            }
+            return level[sink] >= 0;
+        }
+        
+        int push(int node, int sink, int limit) {
+            if (node == sink) return limit;
+            for (size_t& i = next_edge[node]; i < adj[node].size(); ++i) {
+                Edge& edge = adj[node][i];
+                if (edge.cap <= 0 || level[edge.to] != level[node] + 1) continue;
+                int pushed = push(edge.to, sink, std::min(limit, edge.cap));
+                if (pushed > 0) {
+                    edge.cap -= pushed;
+                    adj[edge.to][edge.rev].cap += pushed;
+                    return pushed;
+                }
+            }
+            return 0;
+        }
+    
+    public:
+        int add_node() {
+            adj.emplace_back();
+            return static_cast<int>(adj.size()) - 1;
+        }
+        
+        // Returns the edge index within adj[from]
+        size_t add_edge(int from, int to, int cap) {
+            adj[from].push_back(Edge{to, static_cast<int>(adj[to].size()), cap});
+            adj[to].push_back(Edge{from, static_cast<int>(adj[from].size()) - 1, 0});
+            return adj[from].size() - 1;
+        }
+        
+        int flow_on(int from, size_t edge_index) const {
+            const Edge& edge = adj[from][edge_index];
+            return adj[edge.to][edge.rev].cap;
+        }
+        
+        int max_flow(int source, int sink) {
+            int total = 0;
+            while (build_levels(source, sink)) {
+                next_edge.assign(adj.size(), 0);
+                while (int pushed = push(source, sink, std::numeric_limits<int>::max())) {
+                    total += pushed;
+                }
+            }
+            return total;
+        }
+    };
+    
+    Scheduler& scheduler;
+    size_t worker_count;
+    
+    // Run task(i) for every i below count on up to workers threads, the
+    // calling thread included. The first exception is rethrown after all
+    // threads have finished.
+    template <typename Task>
+    static void run_parallel(size_t count, size_t workers, const Task& task) {
+        std::atomic<size_t> next(0);
+        std::mutex error_mutex;
+        std::exception_ptr error;
+        auto work = [&]() {
+            for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;) {
+                try {
+                    task(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error) error = std::current_exception();
+                }
+            }
+        };
+        
+        std::vector<std::thread> threads;
+        for (size_t w = 1; w < std::min(workers, count); ++w) {
+            threads.emplace_back(work);
+        }
+        work();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        if (error) std::rethrow_exception(error);
+    }
+    
+    // plan() on up to workers threads, treating the slots of the taken
+    // bookings as busy for their HR managers and interviewers
+    AssignmentPlan plan_around(const AssignmentProblem& problem, size_t workers,
+                               const std::vector<ScheduleRequest>& taken) const {
+        AssignmentPlan result;
+        
+        // Slot grid over the window
+        std::vector<TimeSlot> grid;
+        if (problem.duration > std::chrono::system_clock::duration::zero()) {
+            for (auto start = problem.window.start_time;
+                 start + problem.duration <= problem.window.end_time; start += problem.duration) {
+                grid.push_back(TimeSlot(start, start + problem.duration));
+            }
+        }
+        
+        // Free masks for every involved user, computed in parallel
+        std::vector<int> user_ids = users_of(problem);
+        std::vector<std::vector<char>> masks(user_ids.size());
+        run_parallel(user_ids.size(), workers, [&](size_t i) {
+            masks[i] = scheduler.free_slot_mask(user_ids[i], grid);
+        });
+        std::unordered_map<int, std::vector<char>> free_masks;
+        for (size_t i = 0; i < user_ids.size(); ++i) {
+            free_masks[user_ids[i]] = std::move(masks[i]);
+        }
+        for (const ScheduleRequest& booking : taken) {
+            for (size_t t = 0; t < grid.size(); ++t) {
+                if (!grid[t].overlaps(booking.time_slot)) continue;
+                for (int user_id : {booking.hr_manager_id, booking.interviewer_id}) {
+                    auto it = free_masks.find(user_id);
+                    if (it != free_masks.end()) it->second[t] = 0;
+                }
+            }
+        }
+        
+        // Group candidates by their interviewer set
+        std::map<std::vector<int>, std::vector<size_t>> groups;
+        for (size_t c = 0; c < problem.candidates.size(); ++c) {
+            std::vector<int> key = problem.candidates[c].interviewer_ids;
+            std::sort(key.begin(), key.end());
+            key.erase(std::unique(key.begin(), key.end()), key.end());
+            groups[key].push_back(c);
+        }
+        
+        FlowGraph graph;
+        int source = graph.add_node();
+        int sink = graph.add_node();
+        
+        // Slot nodes, capped by the number of free HR managers
+        std::vector<std::vector<int>> free_hr(grid.size());
+        std::vector<int> slot_nodes(grid.size());
+        for (size_t t = 0; t < grid.size(); ++t) {
+            for (int hr_id : problem.hr_manager_ids) {
+                if (free_masks[hr_id][t]) free_hr[t].push_back(hr_id);
+            }
+            slot_nodes[t] = graph.add_node();
+            graph.add_edge(slot_nodes[t], sink, static_cast<int>(free_hr[t].size()));
+        }
+        
+        // (interviewer, slot) nodes, created on demand where the interviewer is free
+        std::map<std::pair<int, size_t>, int> pair_nodes;
+        auto pair_node = [&](int interviewer_id, size_t t) {
+            auto it = pair_nodes.find(std::make_pair(interviewer_id, t));
+            if (it != pair_nodes.end()) return it->second;
+            int node = graph.add_node();
+            graph.add_edge(node, slot_nodes[t], 1);
+            pair_nodes.emplace(std::make_pair(interviewer_id, t), node);
+            return node;
+        };
+        
+        struct GroupEdge {
+            int interviewer_id;
+            size_t slot;
+            size_t edge;
+        };
+        std::vector<int> group_nodes;
+        std::vector<std::vector<GroupEdge>> group_edges;
+        for (const auto& group : groups) {
+            int node = graph.add_node();
+            group_nodes.push_back(node);
+            group_edges.emplace_back();
+            graph.add_edge(source, node, static_cast<int>(group.second.size()));
+            for (int interviewer_id : group.first) {
+                const std::vector<char>& mask = free_masks[interviewer_id];
+                for (size_t t = 0; t < grid.size(); ++t) {
+                    if (!mask[t] || free_hr[t].empty()) continue;
+                    size_t edge = graph.add_edge(node, pair_node(interviewer_id, t), 1);
+                    group_edges.back().push_back(GroupEdge{interviewer_id, t, edge});
+                }
+            }
+        }
+        
+        graph.max_flow(source, sink);
+        
+        // Hand each used (interviewer, slot) to a candidate of the group and a free HR manager
+        std::vector<size_t> next_hr(grid.size(), 0);
+        size_t g = 0;
+        for (const auto& group : groups) {
+            const std::vector<size_t>& members = group.second;
+            size_t member = 0;
+            for (const GroupEdge& edge : group_edges[g]) {
+                if (member == members.size()) break;
+                if (graph.flow_on(group_nodes[g], edge.edge) == 0) continue;
+                
+                const AssignmentCandidate& candidate = problem.candidates[members[member]];
+                int hr_id = free_hr[edge.slot][next_hr[edge.slot]++];
+                result.bookings.push_back(ScheduleRequest{candidate.candidate_name, candidate.position,
+                                                          hr_id, edge.interviewer_id, grid[edge.slot]});
+                result.placed.push_back(members[member++]);
+            }
+            for (; member < members.size(); ++member) {
+                result.unplaced.push_back(members[member]);
+            }
+            ++g;
+        }
+        
+        return result;
+    }
+    
+    // Sorted, distinct ids of every HR manager and interviewer in a problem
+    static std::vector<int> users_of(const AssignmentProblem& problem) {
+        std::vector<int> user_ids(problem.hr_manager_ids);
+        for (const AssignmentCandidate& candidate : problem.candidates) {
+            user_ids.insert(user_ids.end(), candidate.interviewer_ids.begin(),
+                            candidate.interviewer_ids.end());
+        }
+        std::sort(user_ids.begin(), user_ids.end());
+        user_ids.erase(std::unique(user_ids.begin(), user_ids.end()), user_ids.end());
+        return user_ids;
+    }
+
+public:
+    explicit AssignmentEngine(Scheduler& scheduler, size_t worker_count = 0)
+        : scheduler(scheduler),
+          worker_count(worker_count ? worker_count : std::max(1u, std::thread::hardware_concurrency())) {}
+    
+    // Compute a conflict-free schedule placing as many candidates as possible
+    AssignmentPlan plan(const AssignmentProblem& problem) const {
+        return plan_around(problem, worker_count, std::vector<ScheduleRequest>());
+    }
+    
+    // Plan several hiring events. Events that share a user are planned one
+    // after another, each around the bookings of the ones before it, so the
+    // plans never conflict with each other; unrelated events run concurrently.
+    std::vector<AssignmentPlan> plan_all(const std::vector<AssignmentProblem>& problems) const {
+        // Union events that share a user
+        std::vector<size_t> parent(problems.size());
+        for (size_t i = 0; i < problems.size(); ++i) {
+            parent[i] = i;
+        }
+        auto root = [&](size_t i) {
+            while (parent[i] != i) i = parent[i] = parent[parent[i]];
+            return i;
+        };
+        std::unordered_map<int, size_t> first_event;
+        for (size_t i = 0; i < problems.size(); ++i) {
+            for (int user_id : users_of(problems[i])) {
+                auto inserted = first_event.emplace(user_id, i);
+                if (!inserted.second) parent[root(i)] = root(inserted.first->second);
+            }
+        }
+        
+        // Groups of related events, each in input order
+        std::vector<std::vector<size_t>> groups;
+        std::unordered_map<size_t, size_t> group_of;
+        for (size_t i = 0; i < problems.size(); ++i) {
+            auto inserted = group_of.emplace(root(i), groups.size());
+            if (inserted.second) groups.emplace_back();
+            groups[inserted.first->second].push_back(i);
+        }
+        
+        // Split the workers between the groups running at once
+        size_t group_workers = std::max<size_t>(1, std::min(worker_count, groups.size()));
+        size_t mask_workers = std::max<size_t>(1, worker_count / group_workers);
+        std::vector<AssignmentPlan> plans(problems.size());
+        run_parallel(groups.size(), group_workers, [&](size_t g) {
+            std::vector<ScheduleRequest> taken;
+            for (size_t i : groups[g]) {
+                plans[i] = plan_around(problems[i], mask_workers, taken);
+                taken.insert(taken.end(), plans[i].bookings.begin(), plans[i].bookings.end());
+            }
+        });
+        return plans;
+    }
+    
+    // Book a plan through the batch path. Bookings that became invalid since
+    // planning are reported in the results and the rest are still committed.
+    std::vector<ScheduleResult> commit(const AssignmentPlan& plan) {
+        return scheduler.schedule_batch(plan.bookings);
+    }
+};
+
+// One round of an interview loop and the interviewers who may run it
+struct LoopRound {
+    std::vector<int> interviewer_ids;
+    std::chrono::system_clock::duration duration;
+};
+
+// Back-to-back rounds for one candidate, hosted by a single HR manager.
+// Start times are tried from the beginning of the window in steps of step.
+struct LoopRequest {
+    std::string candidate_name;
+    std::string position;
+    int hr_manager_id;
+    std::vector<LoopRound> rounds;
+    TimeSlot window;
+    std::chrono::system_clock::duration step;
+    
+    LoopRequest(const std::string& candidate_name, const std::string& position, int hr_manager_id,
+                const TimeSlot& window,
+                std::chrono::system_clock::duration step = std::chrono::minutes(15))
+        : candidate_name(candidate_name), position(position), hr_manager_id(hr_manager_id),
+          window(window), step(step) {}
+};
+
+// Outcome of a loop booking; interview_ids follow the round order
+struct LoopResult {
+    ScheduleError error;
+    std::vector<int> interview_ids;
+};
+
+// Finds the earliest start time at which every round of a loop can be given a
+// distinct free interviewer, and books all rounds in one all-or-nothing batch.
+//
+// Free/busy state is read once per user and round, so the search itself runs
+// on plain masks without touching the scheduler. Each candidate start time is
+// a task; workers take tasks from the front of their own deque and steal from
+// the back of others, and tasks later than the best solution found so far are
+// skipped.
+class LoopPlanner {
+private:
+    // Candidate interviewers of one round with their free mask over start times
+    struct RoundOptions {
+        size_t round;
+        std::vector<int> interviewer_ids;
+        std::vector<std::vector<char>> free;
+    };
+    
+    // Deque of start indices owned by one worker
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+    
+    Scheduler& scheduler;
+    size_t worker_count;
+    
+    static bool pop_front(TaskQueue& queue, size_t& task) {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) return false;
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        return true;
+    }
+    
+    static bool steal_back(TaskQueue& queue, size_t& task) {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) return false;
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+        return true;
+    }
+    
+    // Depth-first choice of distinct interviewers for the rounds, most
+    // constrained round first
+    static bool assign_rounds(const std::vector<const RoundOptions*>& order, size_t depth, size_t start,
+                              std::vector<int>& chosen) {
+        if (depth == order.size()) return true;
+        
+        const RoundOptions& options = *order[depth];
+        for (size_t i = 0; i < options.interviewer_ids.size(); ++i) {
+            int interviewer_id = options.interviewer_ids[i];
+            if (!options.free[i][start]) continue;
+            if (std::find(chosen.begin(), chosen.end(), interviewer_id) != chosen.end()) continue;
+            
+            chosen[options.round] = interviewer_id;
+            if (assign_rounds(order, depth + 1, start, chosen)) return true;
+            chosen[options.round] = 0;
+        }
+        return false;
+    }
+    
+    static bool search_start(const std::vector<RoundOptions>& rounds, size_t start, std::vector<int>& chosen) {
+        std::vector<std::pair<size_t, const RoundOptions*>> ranked;
+        for (const RoundOptions& options : rounds) {
+            size_t free_count = 0;
+            for (const std::vector<char>& mask : options.free) {
+                free_count += mask[start] ? 1 : 0;
+            }
+            if (free_count == 0) return false;
+            ranked.push_back(std::make_pair(free_count, &options));
+        }
+        std::stable_sort(ranked.begin(), ranked.end(),
+                         [](const std::pair<size_t, const RoundOptions*>& a,
+                            const std::pair<size_t, const RoundOptions*>& b) { return a.first < b.first; });
+        
+        std::vector<const RoundOptions*> order;
+        for (const auto& entry : ranked) {
+            order.push_back(entry.second);
+        }
+        chosen.assign(rounds.size(), 0);
+        return assign_rounds(order, 0, start, chosen);
+    }
+
+public:
+    explicit LoopPlanner(Scheduler& scheduler, size_t worker_count = 0)
+        : scheduler(scheduler),
+          worker_count(worker_count ? worker_count : std::max(1u, std::thread::hardware_concurrency())) {}
+    
+    // Search for the earliest feasible loop. On success, bookings holds one
+    // request per round in round order.
+    ScheduleError find(const LoopRequest& request, std::vector<ScheduleRequest>& bookings) const {
+        bookings.clear();
+        
+        const User* hr_manager = scheduler.get_user(request.hr_manager_id);
+        if (!hr_manager) return ScheduleError::INVALID_USER;
+        if (hr_manager->get_role() != UserRole::HR_MANAGER) return ScheduleError::NOT_HR_MANAGER;
+        if (request.rounds.empty()) return ScheduleError::NO_FEASIBLE_LOOP;
+        
+        // Round offsets from the loop start
+        std::vector<std::chrono::system_clock::duration> offsets;
+        std::chrono::system_clock::duration total = std::chrono::system_clock::duration::zero();
+        for (const LoopRound& round : request.rounds) {
+            offsets.push_back(total);
+            total += round.duration;
+        }
+        
+        std::vector<std::chrono::system_clock::time_point> starts;
+        if (request.step > std::chrono::system_clock::duration::zero()) {
+            for (auto start = request.window.start_time; start + total <= request.window.end_time;
+                 start += request.step) {
+                starts.push_back(start);
+            }
+        }
+        
+        // The HR manager hosts the whole loop
+        std::vector<TimeSlot> spans;
+        for (const auto& start : starts) {
+            spans.push_back(TimeSlot(start, start + total));
+        }
+        std::vector<char> hr_free = scheduler.free_slot_mask(request.hr_manager_id, spans);
+        
+        // Free masks of every round's interviewers, over the same start times
+        std::vector<RoundOptions> rounds(request.rounds.size());
+        for (size_t r = 0; r < request.rounds.size(); ++r) {
+            rounds[r].round = r;
+            std::vector<TimeSlot> slots;
+            for (const auto& start : starts) {
+                slots.push_back(TimeSlot(start + offsets[r], start + offsets[r] + request.rounds[r].duration));
+            }
+            
+            for (int interviewer_id : request.rounds[r].interviewer_ids) {
+                const User* interviewer = scheduler.get_user(interviewer_id);
+                if (!interviewer || interviewer->get_role() != UserRole::INTERVIEWER) continue;
+                rounds[r].interviewer_ids.push_back(interviewer_id);
+                rounds[r].free.push_back(scheduler.free_slot_mask(interviewer_id, slots));
+            }
+            if (rounds[r].interviewer_ids.empty()) return ScheduleError::NOT_INTERVIEWER;
+        }
+        
+        // Deal start times out in contiguous runs so early times are searched first
+        size_t workers = std::max<size_t>(1, std::min(worker_count, starts.size()));
+        std::vector<TaskQueue> queues(workers);
+        for (size_t i = 0; i < starts.size(); ++i) {
+            if (hr_free[i]) queues[i * workers / starts.size()].tasks.push_back(i);
+        }
+        
+        std::atomic<size_t> best(starts.size());
+        std::mutex best_mutex;
+        std::vector<int> best_choice;
+        
+        auto work = [&](size_t self) {
+            std::vector<int> chosen;
+            size_t task;
+            for (;;) {
+                bool found = pop_front(queues[self], task);
+                for (size_t k = 1; !found && k < workers; ++k) {
+                    found = steal_back(queues[(self + k) % workers], task);
+                }
+                if (!found) return;
+                if (task >= best.load(std::memory_order_relaxed)) continue;
+                
+                if (search_start(rounds, task, chosen)) {
+                    std::lock_guard<std::mutex> lock(best_mutex);
+                    if (task < best.load(std::memory_order_relaxed)) {
+                        best.store(task, std::memory_order_relaxed);
+                        best_choice = chosen;
+                    }
+                }
+            }
+        };
+        
+        std::vector<std::thread> threads;
+        for (size_t w = 1; w < workers; ++w) {
+            threads.emplace_back(work, w);
+        }
+        work(0);
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        
+        size_t chosen_start = best.load();
+        if (chosen_start == starts.size()) return ScheduleError::NO_FEASIBLE_LOOP;
+        
+        for (size_t r = 0; r < request.rounds.size(); ++r) {
+            auto start = starts[chosen_start] + offsets[r];
+            bookings.push_back(ScheduleRequest{request.candidate_name, request.position, request.hr_manager_id,
+                                               best_choice[r], TimeSlot(start, start + request.rounds[r].duration)});
+        }
+        return ScheduleError::NONE;
+    }
+    
+    // Find and book a loop atomically. If another booking takes one of the
+    // chosen slots between search and commit, the search is repeated.
+    LoopResult book(const LoopRequest& request, int max_attempts = 3) {
+        LoopResult result{ScheduleError::NO_FEASIBLE_LOOP, std::vector<int>()};
+        std::vector<ScheduleRequest> bookings;
+        
+        for (int attempt = 0; attempt < max_attempts; ++attempt) {
+            result.error = find(request, bookings);
+            if (result.error != ScheduleError::NONE) return result;
+            
+            std::vector<ScheduleResult> outcomes = scheduler.schedule_batch(bookings, true);
+            result.error = ScheduleError::NONE;
+            for (const ScheduleResult& outcome : outcomes) {
+                if (outcome.error != ScheduleError::NONE && outcome.error != ScheduleError::BATCH_ABORTED) {
+                    result.error = outcome.error;
+                    break;
+                }
+            }
+            if (result.error == ScheduleError::NONE) {
+                for (const ScheduleResult& outcome : outcomes) {
+                    result.interview_ids.push_back(outcome.interview_id);
+                }
+                return result;
+            }
+        }
+        return result;
+    }
+};
+
+// Parses "YYYY-MM-DD HH:MM" (optionally ":SS", 'T' accepted as separator) as
+// local time without locale or stream machinery. The UTC offset is cached per
+// calendar day; days on which the offset changes fall back to mktime.
+class LocalTimeParser {
+private:
+    static const int64_t OFFSET_VARIES = std::numeric_limits<int64_t>::min();
+    std::unordered_map<int64_t, int64_t> day_offsets;
+    
+    static bool read_digits(const char* text, int count, int& value) {
+        value = 0;
+        for (int i = 0; i < count; ++i) {
+            if (text[i] < '0' || text[i] > '9') return false;
+            value = value * 10 + (text[i] - '0');
+        }
+        return true;
+    }
+    
+    // Days since 1970-01-01 in the proleptic Gregorian calendar
+    static int64_t days_from_civil(int year, int month, int day) {
+        year -= month <= 2;
+        int64_t era = (year >= 0 ? year : year - 399) / 400;
+        int64_t year_of_era = year - era * 400;
+        int64_t day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+        return era * 146097 + day_of_era - 719468;
+    }
+    
+    static std::time_t local_to_utc(int year, int month, int day, int hour, int minute, int second) {
+        std::tm tm = {};
+        tm.tm_year = year - 1900;
+        tm.tm_mon = month - 1;
+        tm.tm_mday = day;
+        tm.tm_hour = hour;
+        tm.tm_min = minute;
+        tm.tm_sec = second;
+        tm.tm_isdst = -1;
+        return std::mktime(&tm);
+    }
+
+public:
+    bool parse(const char* text, size_t length, std::chrono::system_clock::time_point& out) {
+        int year, month, day, hour, minute, second = 0;
+        if (length != 16 && length != 19) return false;
+        if (!read_digits(text, 4, year) || text[4] != '-' || !read_digits(text + 5, 2, month) ||
+            text[7] != '-' || !read_digits(text + 8, 2, day) || (text[10] != ' ' && text[10] != 'T') ||
+            !read_digits(text + 11, 2, hour) || text[13] != ':' || !read_digits(text + 14, 2, minute)) {
+            return false;
+        }
+        if (length == 19 && (text[16] != ':' || !read_digits(text + 17, 2, second))) return false;
+        if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 59) {
+            return false;
+        }
+        
+        int64_t days = days_from_civil(year, month, day);
+        auto cached = day_offsets.find(days);
+        if (cached == day_offsets.end()) {
+            int64_t midnight = days * 86400;
+            int64_t start_offset = midnight - local_to_utc(year, month, day, 0, 0, 0);
+            int64_t end_offset = midnight + 86399 - local_to_utc(year, month, day, 23, 59, 59);
+            int64_t offset = start_offset == end_offset ? start_offset : int64_t(OFFSET_VARIES);
+            cached = day_offsets.emplace(days, offset).first;
+        }
+        
+        std::time_t utc;
+        if (cached->second == OFFSET_VARIES) {
+            utc = local_to_utc(year, month, day, hour, minute, second);
+        } else {
+            utc = static_cast<std::time_t>(days * 86400 + hour * 3600 + minute * 60 + second - cached->second);
         }
+        out = std::chrono::system_clock::from_time_t(utc);
+        return true;
     }
 };
 
-int Interview::next_id = 1;
+// Input formats understood by BulkImporter
+enum class ImportFormat {
+    CSV,        // user,<name>,<email>,<role> / availability,<email>,<start>,<end>
+    NDJSON      // {"type":"user",...} / {"type":"availability",...} per line
+};
 
-// Scheduler class - main application logic
-class Scheduler {
+// Outcome of an import; messages keeps the first few errors with line numbers
+struct ImportReport {
+    size_t lines = 0;
+    size_t users = 0;
+    size_t slots = 0;
+    size_t errors = 0;
+    std::vector<std::string> messages;
+};
+
+// Streaming importer for users and availability. The file is read through a
+// fixed buffer and cut into chunks of whole lines; chunks are parsed in
+// parallel and committed in file order, each chunk taking one block of user
+// ids. Availability may appear before or after its user and is keyed by
+// email. Each user's windows are collected and added with a single sort and
+// merge pass at the end, spread over the workers.
+//
+// CSV fields may be double-quoted with "" as the escape; blank lines, lines
+// starting with '#' and a header line starting with "type" are skipped.
+// NDJSON objects must be flat with string values. Roles are "hr_manager" or
+// "interviewer" (or "HR Manager"/"Interviewer"), timestamps local
+// "YYYY-MM-DD HH:MM".
+class BulkImporter {
 private:
-    std::map<int, std::unique_ptr<User>> users;
-    std::map<int, std::unique_ptr<Interview>> interviews;
+    static const size_t BUFFER_SIZE = 1 << 20;
+    static const size_t MAX_MESSAGES = 20;
     
-public:
-    // Add user to system
-    int add_user(const std::string& name, const std::string& email, UserRole role) {
-        auto user = std::make_unique<User>(name, email, role);
-        int user_id = user->get_id();
-        users[user_id] = std::move(user);
-        return user_id;
-    }
+    struct ParsedUser {
+        std::string name;
+        std::string email;
+        UserRole role;
+        size_t line;
+    };
     
-    // Get user by ID
-    User* get_user(int user_id) {
-        auto it = users.find(user_id);
-        return (it != users.end()) ? it->second.get() : nullptr;
-    }
+    struct ParsedSlot {
+        std::string email;
+        CompactSlot slot;
+        size_t line;
+    };
     
-    // Get all HR managers
-    std::vector<User*> get_hr_managers() {
-        std::vector<User*> managers;
-        for (auto& pair : users) {
-            if (pair.second->get_role() == UserRole::HR_MANAGER) {
-                managers.push_back(pair.second.get());
+    struct ParsedChunk {
+        std::vector<ParsedUser> users;
+        std::vector<ParsedSlot> slots;
+        std::vector<std::string> messages;
+        size_t errors = 0;
+        size_t lines = 0;
+        
+        void fail(size_t line, const std::string& reason) {
+            if (messages.size() < MAX_MESSAGES) {
+                messages.push_back("line " + std::to_string(line) + ": " + reason);
             }
+            ++errors;
+        }
+    };
+    
+    Scheduler& scheduler;
+    size_t worker_count;
+    
+    static bool parse_role(const std::string& text, UserRole& role) {
+        if (text == "hr_manager" || text == "HR Manager" || text == "hr") {
+            role = UserRole::HR_MANAGER;
+            return true;
+        }
+        if (text == "interviewer" || text == "Interviewer") {
+            role = UserRole::INTERVIEWER;
+            return true;
         }
-        return managers;
+        return false;
     }
     
-    // Get all interviewers
-    std::vector<User*> get_interviewers() {
-        std::vector<User*> interviewers;
-        for (auto& pair : users) {
-            if (pair.second->get_role() == UserRole::INTERVIEWER) {
-                interviewers.push_back(pair.second.get());
+    // Split one CSV line into fields
+    static bool split_csv(const char* begin, const char* end, std::vector<std::string>& fields) {
+        fields.clear();
+        const char* p = begin;
+        for (;;) {
+            fields.emplace_back();
+            std::string& field = fields.back();
+            if (p < end && *p == '"') {
+                for (++p;; ++p) {
+                    if (p == end) return false;
+                    if (*p == '"') {
+                        if (p + 1 < end && p[1] == '"') {
+                            field += '"';
+                            ++p;
+                        } else {
+                            ++p;
+                            break;
+                        }
+                    } else {
+                        field += *p;
+                    }
+                }
+            } else {
+                const char* field_end = p;
+                while (field_end < end && *field_end != ',') ++field_end;
+                field.assign(p, field_end);
+                p = field_end;
             }
+            if (p == end) return true;
+            if (*p != ',') return false;
+            ++p;
         }
-        return interviewers;
     }
     
-    // Schedule interview
-    int schedule_interview(const std::string& candidate_name, 
-                          const std::string& position,
-                          int hr_manager_id, 
-                          int interviewer_id, 
-                          const TimeSlot& time_slot) {
-        
-        User* hr_manager = get_user(hr_manager_id);
-        User* interviewer = get_user(interviewer_id);
-        
-        if (!hr_manager || !interviewer) {
-            throw std::runtime_error("Invalid user ID");
-        }
-        
-        if (hr_manager->get_role() != UserRole::HR_MANAGER) {
-            throw std::runtime_error("User is not an HR manager");
-        }
-        
-        if (interviewer->get_role() != UserRole::INTERVIEWER) {
-            throw std::runtime_error("User is not an interviewer");
-        }
-        
-        // Check availability
-        if (!hr_manager->is_available(time_slot)) {
-            throw std::runtime_error("HR manager is not available at this time");
-        }
-        
-        if (!interviewer->is_available(time_slot)) {
-            throw std::runtime_error("Interviewer is not available at this time");
-        }
-        
-        // Check for conflicts with existing interviews
-        if (has_conflict(hr_manager_id, time_slot) || has_conflict(interviewer_id, time_slot)) {
-            throw std::runtime_error("Time slot conflicts with existing interview");
+    static bool parse_json_string(const char*& p, const char* end, std::string& out) {
+        out.clear();
+        if (p == end || *p != '"') return false;
+        for (++p; p < end; ++p) {
+            char c = *p;
+            if (c == '"') {
+                ++p;
+                return true;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (++p == end) return false;
+            switch (*p) {
+                case '"': case '\\': case '/': out += *p; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    if (end - p < 5) return false;
+                    unsigned code = 0;
+                    for (int i = 1; i <= 4; ++i) {
+                        char h = p[i];
+                        code <<= 4;
+                        if (h >= '0' && h <= '9') code |= h - '0';
+                        else if (h >= 'a' && h <= 'f') code |= h - 'a' + 10;
+                        else if (h >= 'A' && h <= 'F') code |= h - 'A' + 10;
+                        else return false;
+                    }
+                    p += 4;
+                    // Basic multilingual plane only, encoded as UTF-8
+                    if (code < 0x80) {
+                        out += static_cast<char>(code);
+                    } else if (code < 0x800) {
+                        out += static_cast<char>(0xC0 | (code >> 6));
+                        out += static_cast<char>(0x80 | (code & 0x3F));
+                    } else {
+                        out += static_cast<char>(0xE0 | (code >> 12));
+                        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                        out += static_cast<char>(0x80 | (code & 0x3F));
+                    }
+                    break;
+                }
+                default: return false;
+            }
         }
-        
-        // Create interview
-        auto interview = std::make_unique<Interview>(candidate_name, position, 
-                                                   hr_manager_id, interviewer_id, time_slot);
-        int interview_id = interview->get_id();
-        
-        // Add to users' scheduled interviews
-        hr_manager->add_scheduled_interview(interview_id);
-        interviewer->add_scheduled_interview(interview_id);
-        
-        interviews[interview_id] = std::move(interview);
-        
-        return interview_id;
+        return false;
     }
     
-    // Check for scheduling conflicts
-    bool has_conflict(int user_id, const TimeSlot& time_slot) {
-        User* user = get_user(user_id);
-        if (!user) return false;
+    // Parse a flat JSON object of string values into name/value pairs
+    static bool split_json(const char* p, const char* end, std::vector<std::string>& fields) {
+        fields.clear();
+        auto skip_space = [&]() { while (p < end && (*p == ' ' || *p == '\t')) ++p; };
         
-        for (int interview_id : user->get_scheduled_interviews()) {
-            auto it = interviews.find(interview_id);
-            if (it != interviews.end() && 
-                it->second->get_status() == InterviewStatus::SCHEDULED &&
-                it->second->get_time_slot().overlaps(time_slot)) {
-                return true;
+        skip_space();
+        if (p == end || *p != '{') return false;
+        ++p;
+        skip_space();
+        if (p < end && *p == '}') return true;
+        
+        for (;;) {
+            std::string key, value;
+            skip_space();
+            if (!parse_json_string(p, end, key)) return false;
+            skip_space();
+            if (p == end || *p != ':') return false;
+            ++p;
+            skip_space();
+            if (!parse_json_string(p, end, value)) return false;
+            fields.push_back(std::move(key));
+            fields.push_back(std::move(value));
+            skip_space();
+            if (p == end) return false;
+            if (*p == '}') {
+                ++p;
+                skip_space();
+                return p == end;
             }
+            if (*p != ',') return false;
+            ++p;
         }
-        return false;
     }
     
-    // Get interview by ID
-    Interview* get_interview(int interview_id) {
-        auto it = interviews.find(interview_id);
-        return (it != interviews.end()) ? it->second.get() : nullptr;
+    static const std::string* json_field(const std::vector<std::string>& fields, const char* key) {
+        for (size_t i = 0; i + 1 < fields.size(); i += 2) {
+            if (fields[i] == key) return &fields[i + 1];
+        }
+        return nullptr;
     }
     
-    // Cancel interview
-    bool cancel_interview(int interview_id) {
-        Interview* interview = get_interview(interview_id);
-        if (!interview) return false;
+    static ParsedChunk parse_chunk(const std::string& text, size_t first_line, ImportFormat format) {
+        static thread_local LocalTimeParser time_parser;
+        ParsedChunk chunk;
+        std::vector<std::string> fields;
         
-        interview->set_status(InterviewStatus::CANCELLED);
-        
-        // Remove from users' scheduled interviews
-        User* hr_manager = get_user(interview->get_hr_manager_id());
-        User* interviewer = get_user(interview->get_interviewer_id());
-        
-        if (hr_manager) hr_manager->remove_scheduled_interview(interview_id);
-        if (interviewer) interviewer->remove_scheduled_interview(interview_id);
+        // Pull the fields of one record type out of either format
+        const std::string* values[4];
+        auto lookup = [&](std::initializer_list<const char*> keys) {
+            size_t i = 0;
+            for (const char* key : keys) {
+                if (format == ImportFormat::CSV) {
+                    values[i] = i + 1 < fields.size() ? &fields[i + 1] : nullptr;
+                } else {
+                    values[i] = json_field(fields, key);
+                }
+                if (!values[i]) return false;
+                ++i;
+            }
+            return format == ImportFormat::NDJSON || fields.size() == keys.size() + 1;
+        };
         
-        return true;
+        size_t line = first_line;
+        const char* p = text.data();
+        const char* text_end = p + text.size();
+        while (p < text_end) {
+            const char* line_end = static_cast<const char*>(std::memchr(p, '\n', text_end - p));
+            if (!line_end) line_end = text_end;
+            const char* begin = p;
+            const char* end = line_end;
+            p = line_end + 1;
+            ++chunk.lines;
+            ++line;
+            
+            if (end > begin && end[-1] == '\r') --end;
+            if (begin == end || *begin == '#') continue;
+            
+            bool split = format == ImportFormat::CSV ? split_csv(begin, end, fields)
+                                                     : split_json(begin, end, fields);
+            if (!split) {
+                chunk.fail(line, "malformed record");
+                continue;
+            }
+            const std::string* type = format == ImportFormat::CSV ? &fields[0] : json_field(fields, "type");
+            if (!type) {
+                chunk.fail(line, "missing record type");
+                continue;
+            }
+            if (format == ImportFormat::CSV && line == 1 && *type == "type") continue;
+            
+            if (*type == "user") {
+                UserRole role;
+                if (!lookup({"name", "email", "role"})) {
+                    chunk.fail(line, "user needs name, email and role");
+                } else if (!parse_role(*values[2], role)) {
+                    chunk.fail(line, "unknown role '" + *values[2] + "'");
+                } else {
+                    chunk.users.push_back(ParsedUser{*values[0], *values[1], role, line});
+                }
+            } else if (*type == "availability") {
+                std::chrono::system_clock::time_point start, finish;
+                if (!lookup({"email", "start", "end"})) {
+                    chunk.fail(line, "availability needs email, start and end");
+                } else if (!time_parser.parse(values[1]->data(), values[1]->size(), start) ||
+                           !time_parser.parse(values[2]->data(), values[2]->size(), finish)) {
+                    chunk.fail(line, "bad timestamp, expected YYYY-MM-DD HH:MM");
+                } else if (finish <= start) {
+                    chunk.fail(line, "availability ends before it starts");
+                } else if (!CompactTime::in_range(TimeSlot(start, finish))) {
+                    chunk.fail(line, "availability is outside the range the scheduler can store");
+                } else {
+                    chunk.slots.push_back(ParsedSlot{*values[0], CompactTime::to_compact_within(TimeSlot(start, finish)),
+                                                     line});
+                }
+            } else {
+                chunk.fail(line, "unknown record type '" + *type + "'");
+            }
+        }
+        return chunk;
     }
+
+public:
+    explicit BulkImporter(Scheduler& scheduler, size_t worker_count = 0)
+        : scheduler(scheduler),
+          worker_count(worker_count ? worker_count : std::max(1u, std::thread::hardware_concurrency())) {}
     
-    // Get all interviews for a user
-    std::vector<Interview*> get_user_interviews(int user_id) {
-        std::vector<Interview*> user_interviews;
-        User* user = get_user(user_id);
-        if (!user) return user_interviews;
+    // Import a file. Bad records are counted and skipped; only failing to
+    // open the file throws.
+    ImportReport import_file(const std::string& path, ImportFormat format) {
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) throw std::runtime_error("Cannot open " + path);
         
-        for (int interview_id : user->get_scheduled_interviews()) {
-            auto it = interviews.find(interview_id);
-            if (it != interviews.end()) {
-                user_interviews.push_back(it->second.get());
+        ImportReport report;
+        std::unordered_map<std::string, int> user_ids;
+        for (const std::vector<User*>& existing : {scheduler.get_hr_managers(), scheduler.get_interviewers()}) {
+            for (const User* user : existing) {
+                user_ids.emplace(user->get_email(), user->get_id());
             }
         }
-        return user_interviews;
-    }
-    
-    // Get all interviews
-    std::vector<Interview*> get_all_interviews() {
-        std::vector<Interview*> all_interviews;
-        for (auto& pair : interviews) {
-            all_interviews.push_back(pair.second.get());
+        std::unordered_map<std::string, std::vector<CompactSlot>> pending_slots;
+        
+        auto merge_messages = [&](std::vector<std::string>& messages, size_t errors) {
+            for (std::string& message : messages) {
+                if (report.messages.size() < MAX_MESSAGES) report.messages.push_back(std::move(message));
+            }
+            report.errors += errors;
+        };
+        
+        // Register a parsed chunk's users in file order from one id block
+        auto commit = [&](ParsedChunk chunk) {
+            report.lines += chunk.lines;
+            std::vector<std::string> messages;
+            size_t errors = 0;
+            IdBlock ids = User::id_generator().reserve(static_cast<int>(chunk.users.size()));
+            for (ParsedUser& user : chunk.users) {
+                int user_id = ids.take();
+                if (!user_ids.emplace(user.email, user_id).second) {
+                    if (messages.size() < MAX_MESSAGES) {
+                        messages.push_back("line " + std::to_string(user.line) + ": duplicate email " +
+                                           user.email);
+                    }
+                    ++errors;
+                    continue;
+                }
+                scheduler.add_user_with_id(user_id, user.name, user.email, user.role);
+                ++report.users;
+            }
+            for (ParsedSlot& slot : chunk.slots) {
+                pending_slots[slot.email].push_back(slot.slot);
+            }
+            merge_messages(chunk.messages, chunk.errors);
+            merge_messages(messages, errors);
+        };
+        
+        std::vector<char> buffer(BUFFER_SIZE);
+        std::string carry;
+        std::deque<std::future<ParsedChunk>> in_flight;
+        size_t next_line = 0;
+        for (;;) {
+            size_t read = std::fread(buffer.data(), 1, buffer.size(), file);
+            bool at_end = read < buffer.size();
+            
+            // Hand off everything up to the last complete line
+            size_t cut = read;
+            if (!at_end) {
+                while (cut > 0 && buffer[cut - 1] != '\n') --cut;
+            }
+            std::string text;
+            text.reserve(carry.size() + cut);
+            text.append(carry).append(buffer.data(), cut);
+            carry.assign(buffer.data() + cut, read - cut);
+            
+            if (!text.empty()) {
+                size_t first_line = next_line;
+                next_line += static_cast<size_t>(std::count(text.begin(), text.end(), '\n'));
+                in_flight.push_back(std::async(std::launch::async, [text = std::move(text), first_line, format]() {
+                    return parse_chunk(text, first_line, format);
+                }));
+            }
+            while (in_flight.size() >= worker_count || (at_end && !in_flight.empty())) {
+                commit(in_flight.front().get());
+                in_flight.pop_front();
+            }
+            if (at_end) break;
         }
-        return all_interviews;
-    }
-    
-    // Display system statistics
-    void display_statistics() {
-        std::cout << "\n=== CLOUDFIT SCHEDULING STATISTICS ===\n";
-        std::cout << "Total Users: " << users.size() << std::endl;
-        std::cout << "HR Managers: " << get_hr_managers().size() << std::endl;
-        std::cout << "Interviewers: " << get_interviewers().size() << std::endl;
-        std::cout << "Total Interviews: " << interviews.size() << std::endl;
+        std::fclose(file);
         
-        int scheduled = 0, completed = 0, cancelled = 0;
-        for (auto& pair : interviews) {
-            switch (pair.second->get_status()) {
-                case InterviewStatus::SCHEDULED: scheduled++; break;
-                case InterviewStatus::COMPLETED: completed++; break;
-                case InterviewStatus::CANCELLED: cancelled++; break;
-                case InterviewStatus::RESCHEDULED: break;
+        // One sort and merge per user, users spread over the workers
+        std::vector<std::pair<int, std::vector<CompactSlot>*>> targets;
+        for (auto& entry : pending_slots) {
+            auto user = user_ids.find(entry.first);
+            if (user == user_ids.end()) {
+                if (report.messages.size() < MAX_MESSAGES) {
+                    report.messages.push_back("availability for unknown user " + entry.first);
+                }
+                report.errors += entry.second.size();
+                continue;
             }
+            report.slots += entry.second.size();
+            targets.push_back(std::make_pair(user->second, &entry.second));
         }
         
-        std::cout << "Scheduled: " << scheduled << std::endl;
-        std::cout << "Completed: " << completed << std::endl;
-        std::cout << "Cancelled: " << cancelled << std::endl;
-        std::cout << "=======================================\n";
+        std::vector<std::future<void>> merges;
+        size_t workers = std::min(worker_count, std::max<size_t>(1, targets.size()));
+        for (size_t w = 0; w < workers; ++w) {
+            merges.push_back(std::async(std::launch::async, [this, w, workers, &targets]() {
+                for (size_t i = w; i < targets.size(); i += workers) {
+                    scheduler.add_compact_availability(targets[i].first, std::move(*targets[i].second));
+                }
+            }));
+        }
+        for (auto& merge : merges) {
+            merge.get();
+        }
+        return report;
     }
 };
 
@@ -347,36 +7185,126 @@ std::chrono::system_clock::time_point parse_datetime(const std::string& datetime
     return std::chrono::system_clock::from_time_t(std::mktime(&tm));
 }
 
+// Fixed-size output buffer that writes to a stream only when full, on
+// flush() and on destruction, so a listing costs one write per 64 KiB
+// instead of one flush per line
+class OutputBuffer {
+private:
+    static const size_t CAPACITY = 64 * 1024;
+    
+    std::ostream& out;
+    std::unique_ptr<char[]> data;
+    size_t used = 0;
+    
+    // Make room for count more characters
+    char* reserve(size_t count) {
+        if (CAPACITY - used < count) flush_buffer();
+        return data.get() + used;
+    }
+    
+    void flush_buffer() {
+        out.write(data.get(), static_cast<std::streamsize>(used));
+        used = 0;
+    }
+
+public:
+    explicit OutputBuffer(std::ostream& out) : out(out), data(new char[CAPACITY]) {}
+    
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+    
+    ~OutputBuffer() { flush(); }
+    
+    OutputBuffer& append(const char* text, size_t length) {
+        if (length > CAPACITY) {
+            flush_buffer();
+            out.write(text, static_cast<std::streamsize>(length));
+            return *this;
+        }
+        std::memcpy(reserve(length), text, length);
+        used += length;
+        return *this;
+    }
+    
+    OutputBuffer& append(const std::string& text) { return append(text.data(), text.size()); }
+    
+    template <size_t N>
+    OutputBuffer& append(const char (&text)[N]) { return append(text, N - 1); }
+    
+    OutputBuffer& append(char c) {
+        *reserve(1) = c;
+        ++used;
+        return *this;
+    }
+    
+    OutputBuffer& append(long long value) {
+        char* start = reserve(24);
+        char* end = start + 24;
+        char* p = end;
+        unsigned long long magnitude = value < 0 ? 0ULL - static_cast<unsigned long long>(value)
+                                                 : static_cast<unsigned long long>(value);
+        do {
+            *--p = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude);
+        if (value < 0) *--p = '-';
+        size_t length = static_cast<size_t>(end - p);
+        std::memmove(start, p, length);
+        used += length;
+        return *this;
+    }
+    
+    OutputBuffer& append(int value) { return append(static_cast<long long>(value)); }
+    
+    OutputBuffer& append(const TimeSlot& slot) {
+        used = static_cast<size_t>(slot.format(reserve(TimeSlot::FORMATTED_SIZE)) - data.get());
+        return *this;
+    }
+    
+    // Write out everything buffered, then flush the stream
+    void flush() {
+        flush_buffer();
+        out.flush();
+    }
+};
+
+void print_user_details(const User* user, OutputBuffer& out) {
+    out.append("ID: ").append(user->get_id())
+       .append(", Name: ").append(user->get_name())
+       .append(", Email: ").append(user->get_email())
+       .append(", Role: ").append(user->role_to_string()).append('\n');
+}
+
 void print_user_details(const User* user) {
-    std::cout << "ID: " << user->get_id() 
-              << ", Name: " << user->get_name()
-              << ", Email: " << user->get_email()
-              << ", Role: " << user->role_to_string() << std::endl;
+    OutputBuffer out(std::cout);
+    print_user_details(user, out);
 }
 
-void print_interview_details(const Interview* interview, const Scheduler& scheduler) {
-    User* hr = scheduler.get_user(interview->get_hr_manager_id());
-    User* interviewer = scheduler.get_user(interview->get_interviewer_id());
-    
-    std::cout << "Interview ID: " << interview->get_id() << std::endl;
-    std::cout << "Candidate: " << interview->get_candidate_name() << std::endl;
-    std::cout << "Position: " << interview->get_position() << std::endl;
-    std::cout << "HR Manager: " << (hr ? hr->get_name() : "Unknown") << std::endl;
-    std::cout << "Interviewer: " << (interviewer ? interviewer->get_name() : "Unknown") << std::endl;
-    std::cout << "Time: " << interview->get_time_slot().to_string() << std::endl;
-    std::cout << "Status: " << interview->status_to_string() << std::endl;
+void print_interview_details(const Interview* interview, const Scheduler& scheduler, OutputBuffer& out) {
+    const User* hr = scheduler.get_user(interview->get_hr_manager_id());
+    const User* interviewer = scheduler.get_user(interview->get_interviewer_id());
+    
+    out.append("Interview ID: ").append(interview->get_id()).append('\n');
+    out.append("Candidate: ").append(interview->get_candidate_name()).append('\n');
+    out.append("Position: ").append(interview->get_position()).append('\n');
+    static const std::string unknown("Unknown");
+    out.append("HR Manager: ").append(hr ? hr->get_name() : unknown).append('\n');
+    out.append("Interviewer: ").append(interviewer ? interviewer->get_name() : unknown).append('\n');
+    out.append("Time: ").append(interview->get_time_slot()).append('\n');
+    out.append("Status: ").append(interview->status_to_string()).append('\n');
     if (!interview->get_notes().empty()) {
-        std::cout << "Notes: " << interview->get_notes() << std::endl;
+        out.append("Notes: ").append(interview->get_notes()).append('\n');
     }
-    std::cout << "---" << std::endl;
+    out.append("---\n");
 }
 
-// Main application
-int main() {
-    Scheduler scheduler;
-    
-    std::cout << "=== CLOUDFIT INTERVIEW SCHEDULING SYSTEM ===\n\n";
-    
+void print_interview_details(const Interview* interview, const Scheduler& scheduler) {
+    OutputBuffer out(std::cout);
+    print_interview_details(interview, scheduler, out);
+}
+
+// Populate a fresh scheduler with demo users and interviews
+void load_sample_data(Scheduler& scheduler) {
     // Add some sample users
     int hr1 = scheduler.add_user("Alice Johnson", "alice@cloudfit.com", UserRole::HR_MANAGER);
     int hr2 = scheduler.add_user("Bob Smith", "bob@cloudfit.com", UserRole::HR_MANAGER);
@@ -390,17 +7318,14 @@ int main() {
     auto day_after = now + std::chrono::hours(48);
     
     // Add availability slots
-    User* alice = scheduler.get_user(hr1);
-    alice->add_availability(TimeSlot(tomorrow, tomorrow + std::chrono::hours(8)));
-    alice->add_availability(TimeSlot(day_after, day_after + std::chrono::hours(6)));
+    scheduler.add_availability(hr1, TimeSlot(tomorrow, tomorrow + std::chrono::hours(8)));
+    scheduler.add_availability(hr1, TimeSlot(day_after, day_after + std::chrono::hours(6)));
     
-    User* carol = scheduler.get_user(int1);
-    carol->add_availability(TimeSlot(tomorrow, tomorrow + std::chrono::hours(4)));
-    carol->add_availability(TimeSlot(day_after, day_after + std::chrono::hours(8)));
+    scheduler.add_availability(int1, TimeSlot(tomorrow, tomorrow + std::chrono::hours(4)));
+    scheduler.add_availability(int1, TimeSlot(day_after, day_after + std::chrono::hours(8)));
     
-    User* david = scheduler.get_user(int2);
-    david->add_availability(TimeSlot(tomorrow + std::chrono::hours(2), 
-                                   tomorrow + std::chrono::hours(6)));
+    scheduler.add_availability(int2, TimeSlot(tomorrow + std::chrono::hours(2), 
+                                              tomorrow + std::chrono::hours(6)));
     
     // Schedule some sample interviews
     try {
@@ -417,6 +7342,37 @@ int main() {
     } catch (const std::exception& e) {
         std::cout << "Error scheduling interview: " << e.what() << std::endl;
     }
+}
+
+#ifndef CLOUDFIT_BENCHMARK
+
+// Main application
+int main(int argc, char* argv[]) {
+    Scheduler scheduler;
+    
+    std::cout << "=== CLOUDFIT INTERVIEW SCHEDULING SYSTEM ===\n\n";
+    
+    // With a snapshot path, restore the snapshot plus its write-ahead log and
+    // keep logging every change
+    std::string snapshot_path = argc > 1 ? argv[1] : "cloudfit.snapshot";
+    std::unique_ptr<WriteAheadLog> log;
+    if (argc > 1) {
+        try {
+            if (std::ifstream(snapshot_path)) {
+                scheduler.load_snapshot(snapshot_path);
+                std::cout << "Loaded snapshot " << snapshot_path << ".\n";
+            }
+            size_t replayed = scheduler.replay_log(snapshot_path + ".wal");
+            std::cout << "Replayed " << replayed << " log records.\n\n";
+            log = std::make_unique<WriteAheadLog>(snapshot_path + ".wal");
+            scheduler.attach_log(log.get());
+        } catch (const std::exception& e) {
+            std::cout << "Error restoring state: " << e.what() << std::endl;
+            return 1;
+        }
+    } else {
+        load_sample_data(scheduler);
+    }
     
     // Interactive menu
     int choice;
@@ -428,6 +7384,10 @@ int main() {
         std::cout << "4. Cancel interview\n";
         std::cout << "5. View user's interviews\n";
         std::cout << "6. Display statistics\n";
+        std::cout << "7. Save snapshot\n";
+#ifdef CLOUDFIT_METRICS
+        std::cout << "8. Show metrics\n";
+#endif
         std::cout << "0. Exit\n";
         std::cout << "Enter your choice: ";
         
@@ -436,17 +7396,18 @@ int main() {
         switch (choice) {
             case 1: {
                 std::cout << "\n=== ALL USERS ===\n";
-                auto hr_managers = scheduler.get_hr_managers();
-                auto interviewers = scheduler.get_interviewers();
+                UserSpan hr_managers = scheduler.hr_managers();
+                UserSpan interviewers = scheduler.interviewers();
                 
-                std::cout << "HR Managers:\n";
+                OutputBuffer out(std::cout);
+                out.append("HR Managers:\n");
                 for (const auto& user : hr_managers) {
-                    print_user_details(user);
+                    print_user_details(user, out);
                 }
                 
-                std::cout << "\nInterviewers:\n";
+                out.append("\nInterviewers:\n");
                 for (const auto& user : interviewers) {
-                    print_user_details(user);
+                    print_user_details(user, out);
                 }
                 break;
             }
@@ -454,16 +7415,57 @@ int main() {
             case 2: {
                 std::cout << "\n=== ALL INTERVIEWS ===\n";
                 auto interviews = scheduler.get_all_interviews();
+                OutputBuffer out(std::cout);
                 for (const auto& interview : interviews) {
-                    print_interview_details(interview, scheduler);
+                    print_interview_details(interview, scheduler, out);
                 }
                 break;
             }
             
             case 3: {
                 std::cout << "\n=== SCHEDULE NEW INTERVIEW ===\n";
-                std::cout << "Feature not fully implemented in console demo.\n";
-                std::cout << "This would include forms for candidate details, time selection, etc.\n";
+                int hr_id, interviewer_id, minutes;
+                std::cout << "Enter HR manager ID: ";
+                std::cin >> hr_id;
+                std::cout << "Enter interviewer ID: ";
+                std::cin >> interviewer_id;
+                std::cout << "Enter duration in minutes: ";
+                std::cin >> minutes;
+                
+                std::string candidate, position;
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                std::cout << "Enter candidate name: ";
+                std::getline(std::cin, candidate);
+                std::cout << "Enter position: ";
+                std::getline(std::cin, position);
+                
+                // Suggest the next free slots within the coming week
+                auto from = std::chrono::system_clock::now();
+                TimeSlot window(from, from + std::chrono::hours(24 * 7));
+                auto slots = scheduler.find_free_slots(hr_id, interviewer_id,
+                                                       std::chrono::minutes(minutes), window, 5);
+                if (slots.empty()) {
+                    std::cout << "No free slots found in the next 7 days.\n";
+                    break;
+                }
+                
+                std::cout << "Available slots:\n";
+                for (size_t i = 0; i < slots.size(); ++i) {
+                    std::cout << (i + 1) << ". " << slots[i].to_string() << "\n";
+                }
+                std::cout << "Choose a slot (0 to cancel): ";
+                size_t pick;
+                std::cin >> pick;
+                if (pick == 0 || pick > slots.size()) break;
+                
+                int id = 0;
+                ScheduleError error = scheduler.schedule_interview(candidate, position, hr_id,
+                                                                   interviewer_id, slots[pick - 1], id);
+                if (error == ScheduleError::NONE) {
+                    std::cout << "Interview scheduled with ID " << id << ".\n";
+                } else {
+                    std::cout << "Error scheduling interview: " << schedule_error_to_string(error) << std::endl;
+                }
                 break;
             }
             
@@ -491,8 +7493,9 @@ int main() {
                 if (interviews.empty()) {
                     std::cout << "No interviews found for this user.\n";
                 } else {
+                    OutputBuffer out(std::cout);
                     for (const auto& interview : interviews) {
-                        print_interview_details(interview, scheduler);
+                        print_interview_details(interview, scheduler, out);
                     }
                 }
                 break;
@@ -503,6 +7506,27 @@ int main() {
                 break;
             }
             
+            case 7: {
+                try {
+                    if (log) {
+                        scheduler.compact_log(snapshot_path);
+                    } else {
+                        scheduler.save_snapshot(snapshot_path);
+                    }
+                    std::cout << "Snapshot saved to " << snapshot_path << ".\n";
+                } catch (const std::exception& e) {
+                    std::cout << "Error saving snapshot: " << e.what() << std::endl;
+                }
+                break;
+            }
+            
+#ifdef CLOUDFIT_METRICS
+            case 8: {
+                std::cout << metrics_to_prometheus(SchedulerMetrics::collect());
+                break;
+            }
+#endif
+            
             case 0:
                 std::cout << "Goodbye!\n";
                 break;
@@ -515,3 +7539,298 @@ int main() {
     
     return 0;
 }
+
+#else
+
+// Benchmark build: g++ -DCLOUDFIT_BENCHMARK ... replaces the interactive main
+// with a synthetic-workload benchmark of the scheduler hot paths.
+//
+//   ./cloudfit_bench [--interviews N] [--users N] [--density D] [--conflict R] [--seed S]
+//
+// users defaults to interviews / 10; density is the fraction of an 8-hour
+// working day each user is available; conflict is the fraction of booking
+// attempts that repeat a slot the HR manager already holds.
+
+#include <new>
+#include <cmath>
+#include <random>
+#include <cstdlib>
+
+// Every global allocation in the process is counted
+std::atomic<uint64_t> benchmark_allocations(0);
+
+void* operator new(std::size_t size) {
+    benchmark_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+struct BenchmarkConfig {
+    size_t interviews = 10000;
+    size_t users = 0;
+    double density = 0.5;
+    double conflict_ratio = 0.2;
+    unsigned seed = 42;
+};
+
+// Per-operation latencies plus throughput and allocation totals for one phase
+class BenchmarkPhase {
+private:
+    std::string name;
+    std::vector<uint64_t> latencies;
+    uint64_t allocations = 0;
+    double seconds = 0;
+
+public:
+    explicit BenchmarkPhase(const std::string& name) : name(name) {}
+    
+    // Time fn(i) for i in [0, max_ops), stopping early once fn returns false
+    template <typename Fn>
+    void run_while(size_t max_ops, Fn fn) {
+        latencies.assign(max_ops, 0);
+        size_t ops = 0;
+        uint64_t allocations_before = benchmark_allocations.load(std::memory_order_relaxed);
+        auto phase_start = std::chrono::steady_clock::now();
+        bool more = true;
+        while (more && ops < max_ops) {
+            auto start = std::chrono::steady_clock::now();
+            more = fn(ops);
+            latencies[ops++] = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+                    .count());
+        }
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - phase_start).count();
+        allocations = benchmark_allocations.load(std::memory_order_relaxed) - allocations_before;
+        latencies.resize(ops);
+    }
+    
+    // Time fn(i) for i in [0, ops)
+    template <typename Fn>
+    void run(size_t ops, Fn fn) {
+        run_while(ops, [&](size_t i) {
+            fn(i);
+            return true;
+        });
+    }
+    
+    static void print_header() {
+        std::cout << std::left << std::setw(22) << "operation" << std::right << std::setw(10) << "ops"
+                  << std::setw(14) << "ops/s" << std::setw(12) << "p50 ns" << std::setw(12) << "p99 ns"
+                  << std::setw(12) << "allocs/op" << "\n";
+    }
+    
+    void print() {
+        size_t ops = latencies.size();
+        uint64_t p50 = 0, p99 = 0;
+        if (ops > 0) {
+            std::nth_element(latencies.begin(), latencies.begin() + ops / 2, latencies.end());
+            p50 = latencies[ops / 2];
+            size_t tail = std::min(ops - 1, ops * 99 / 100);
+            std::nth_element(latencies.begin(), latencies.begin() + tail, latencies.end());
+            p99 = latencies[tail];
+        }
+        std::cout << std::left << std::setw(22) << name << std::right << std::setw(10) << ops
+                  << std::setw(14) << std::fixed << std::setprecision(0) << (seconds > 0 ? ops / seconds : 0.0)
+                  << std::setw(12) << p50 << std::setw(12) << p99 << std::setw(12) << std::setprecision(2)
+                  << (ops ? static_cast<double>(allocations) / ops : 0.0) << "\n";
+    }
+};
+
+// Stream buffer that discards everything, for timing display_statistics
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+int main(int argc, char* argv[]) {
+    BenchmarkConfig config;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        std::string value = argv[i + 1];
+        if (flag == "--interviews") config.interviews = std::stoull(value);
+        else if (flag == "--users") config.users = std::stoull(value);
+        else if (flag == "--density") config.density = std::stod(value);
+        else if (flag == "--conflict") config.conflict_ratio = std::stod(value);
+        else if (flag == "--seed") config.seed = static_cast<unsigned>(std::stoul(value));
+        else {
+            std::cerr << "Unknown option " << flag << "\n";
+            return 1;
+        }
+    }
+    if (config.users == 0) config.users = std::max<size_t>(10, config.interviews / 10);
+    config.density = std::min(1.0, std::max(1.0 / 16, config.density));
+    config.conflict_ratio = std::min(0.95, std::max(0.0, config.conflict_ratio));
+    
+    // Users: one HR manager for every four interviewers
+    const size_t SLOTS_PER_DAY = 16;
+    const auto SLOT_LENGTH = std::chrono::minutes(30);
+    size_t hr_count = std::max<size_t>(1, config.users / 5);
+    size_t interviewer_count = std::max<size_t>(1, config.users - hr_count);
+    size_t window_slots = static_cast<size_t>(config.density * SLOTS_PER_DAY + 0.5);
+    
+    // Enough days that HR managers end up about half booked
+    double per_hr = static_cast<double>(config.interviews) / hr_count;
+    size_t days = std::max<size_t>(1, static_cast<size_t>(std::ceil(per_hr / (window_slots * 0.5))));
+    
+    std::cout << "=== CLOUDFIT SCHEDULER BENCHMARK ===\n"
+              << "interviews=" << config.interviews << " hr_managers=" << hr_count
+              << " interviewers=" << interviewer_count << " days=" << days
+              << " density=" << config.density << " conflict=" << config.conflict_ratio
+              << " seed=" << config.seed << "\n\n";
+    
+    std::mt19937_64 rng(config.seed);
+    Scheduler scheduler;
+    std::vector<int> hr_ids, interviewer_ids;
+    auto day_start = [&](size_t day) {
+        return CompactTime::get_epoch() + std::chrono::hours(24 * (1461 + day) + 9);
+    };
+    
+    BenchmarkPhase::print_header();
+    
+    BenchmarkPhase add_users("add_user");
+    add_users.run(hr_count + interviewer_count, [&](size_t i) {
+        if (i < hr_count) {
+            hr_ids.push_back(scheduler.add_user("HR " + std::to_string(i), "hr" + std::to_string(i) + "@bench",
+                                                UserRole::HR_MANAGER));
+        } else {
+            interviewer_ids.push_back(scheduler.add_user("Interviewer " + std::to_string(i),
+                                                         "int" + std::to_string(i) + "@bench",
+                                                         UserRole::INTERVIEWER));
+        }
+    });
+    add_users.print();
+    
+    // One window per user per day at a random offset within the working day
+    std::vector<int> all_ids(hr_ids);
+    all_ids.insert(all_ids.end(), interviewer_ids.begin(), interviewer_ids.end());
+    std::vector<uint8_t> window_offset(all_ids.size() * days);
+    for (uint8_t& offset : window_offset) {
+        offset = static_cast<uint8_t>(rng() % (SLOTS_PER_DAY - window_slots + 1));
+    }
+    auto window_of = [&](size_t user_index, size_t day) {
+        auto start = day_start(day) + SLOT_LENGTH * window_offset[user_index * days + day];
+        return TimeSlot(start, start + SLOT_LENGTH * window_slots);
+    };
+    
+    BenchmarkPhase add_availability("add_availability");
+    add_availability.run(all_ids.size() * days, [&](size_t i) {
+        scheduler.add_availability(all_ids[i / days], window_of(i / days, i % days));
+    });
+    add_availability.print();
+    
+    // Plan the booking attempts up front so generation stays out of the
+    // timings. New bookings take a slot both users have free according to
+    // the plan; a conflict_ratio share of attempts repeat the HR manager's
+    // previous booking and must be rejected as conflicts.
+    struct PlannedBooking {
+        uint32_t hr;
+        uint32_t interviewer;
+        uint16_t day;
+        uint8_t slot;
+    };
+    std::vector<PlannedBooking> plan;
+    plan.reserve(static_cast<size_t>(config.interviews / std::max(0.05, 1.0 - config.conflict_ratio)) + 1);
+    std::vector<uint16_t> busy(all_ids.size() * days, 0);
+    std::vector<int32_t> last_planned(hr_ids.size(), -1);
+    auto window_mask = [&](size_t user_index, size_t day) {
+        return static_cast<uint16_t>(((1u << window_slots) - 1) << window_offset[user_index * days + day]);
+    };
+    size_t planned = 0;
+    for (size_t tries = 0; planned < config.interviews && tries < 16 * config.interviews; ++tries) {
+        size_t hr = rng() % hr_ids.size();
+        if (last_planned[hr] >= 0 && plan.size() - planned < config.conflict_ratio * (plan.size() + 1)) {
+            plan.push_back(plan[last_planned[hr]]);
+            continue;
+        }
+        size_t interviewer = hr_ids.size() + rng() % interviewer_ids.size();
+        size_t day = rng() % days;
+        uint16_t& hr_busy = busy[hr * days + day];
+        uint16_t& interviewer_busy = busy[interviewer * days + day];
+        uint32_t open = window_mask(hr, day) & window_mask(interviewer, day) & ~hr_busy & ~interviewer_busy & 0xFFFF;
+        if (open == 0) continue;
+        uint8_t slot = 0;
+        for (size_t skip = rng() % __builtin_popcount(open); ; ++slot) {
+            if ((open >> slot) & 1 && skip-- == 0) break;
+        }
+        hr_busy |= static_cast<uint16_t>(1u << slot);
+        interviewer_busy |= static_cast<uint16_t>(1u << slot);
+        last_planned[hr] = static_cast<int32_t>(plan.size());
+        plan.push_back(PlannedBooking{static_cast<uint32_t>(hr), static_cast<uint32_t>(interviewer),
+                                      static_cast<uint16_t>(day), slot});
+        ++planned;
+    }
+    
+    size_t booked = 0, conflicts = 0, unavailable = 0;
+    BenchmarkPhase schedule("schedule_interview");
+    schedule.run(plan.size(), [&](size_t i) {
+        const PlannedBooking& booking = plan[i];
+        auto start = day_start(booking.day) + SLOT_LENGTH * booking.slot;
+        int interview_id = 0;
+        ScheduleError error = scheduler.schedule_interview(
+            "Candidate", "Software Engineer", all_ids[booking.hr], all_ids[booking.interviewer],
+            TimeSlot(start, start + SLOT_LENGTH), interview_id);
+        if (error == ScheduleError::NONE) {
+            ++booked;
+        } else if (error == ScheduleError::TIME_CONFLICT) {
+            ++conflicts;
+        } else {
+            ++unavailable;
+        }
+    });
+    schedule.print();
+    
+    size_t probes = std::max<size_t>(1, std::min<size_t>(booked, 1000000));
+    auto random_slot = [&]() {
+        auto start = day_start(rng() % days) + SLOT_LENGTH * static_cast<long>(rng() % SLOTS_PER_DAY);
+        return TimeSlot(start, start + SLOT_LENGTH);
+    };
+    
+    BenchmarkPhase conflict_probe("has_conflict");
+    conflict_probe.run(probes, [&](size_t) {
+        volatile bool conflict = scheduler.has_conflict(all_ids[rng() % all_ids.size()], random_slot());
+        (void)conflict;
+    });
+    conflict_probe.print();
+    
+    BenchmarkPhase available_probe("is_available");
+    available_probe.run(probes, [&](size_t) {
+        volatile bool available = scheduler.get_user(all_ids[rng() % all_ids.size()])->is_available(random_slot());
+        (void)available;
+    });
+    available_probe.print();
+    
+    BenchmarkPhase user_interviews("get_user_interviews");
+    user_interviews.run(std::max<size_t>(1, probes / 10), [&](size_t) {
+        volatile size_t count = scheduler.get_user_interviews(all_ids[rng() % all_ids.size()]).size();
+        (void)count;
+    });
+    user_interviews.print();
+    
+    BenchmarkPhase free_slots("find_free_slots");
+    free_slots.run(std::max<size_t>(1, std::min<size_t>(probes / 100, 10000)), [&](size_t) {
+        TimeSlot window(day_start(rng() % days), day_start(0) + std::chrono::hours(24 * days));
+        volatile size_t count = scheduler.find_free_slots(hr_ids[rng() % hr_ids.size()],
+                                                          interviewer_ids[rng() % interviewer_ids.size()],
+                                                          SLOT_LENGTH, window, 5).size();
+        (void)count;
+    });
+    free_slots.print();
+    
+    NullBuffer null_buffer;
+    std::streambuf* console = std::cout.rdbuf(&null_buffer);
+    BenchmarkPhase statistics("display_statistics");
+    statistics.run(1000, [&](size_t) { scheduler.display_statistics(); });
+    std::cout.rdbuf(console);
+    statistics.print();
+    
+    size_t total = booked + conflicts + unavailable;
+    std::cout << "\nbooked=" << booked << " conflicts=" << conflicts << " unavailable=" << unavailable
+              << std::setprecision(1) << " conflict_ratio=" << (total ? 100.0 * conflicts / total : 0.0) << "%\n";
+    return 0;
+}
+
+#endif